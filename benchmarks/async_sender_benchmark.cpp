@@ -0,0 +1,88 @@
+/**
+ * @file async_sender_benchmark.cpp
+ * @brief Time to deliver a burst of reminders: one-by-one MessageSender vs the curl_multi AsyncSender
+ *
+ * The local Bot API stand-in delays every answer to simulate the round trip to Telegram.
+ * Usage: async_sender_benchmark [messages] [delay_ms] [max_in_flight]
+ */
+#include "async_sender.hpp"
+#include "message_sender.hpp"
+#include "local_http_server.hpp"
+#include <curl/curl.h>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using BenchClock = std::chrono::steady_clock;
+
+void report(const std::string& name, std::chrono::duration<double> elapsed, int failed, std::size_t connections) {
+    std::cout << std::left << std::setw(22) << name
+              << std::right << std::fixed << std::setprecision(3) << std::setw(12) << elapsed.count()
+              << std::setw(10) << failed
+              << std::setw(14) << connections << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int messages = argc > 1 ? std::atoi(argv[1]) : 500;
+    const auto delay = std::chrono::milliseconds(argc > 2 ? std::atoi(argv[2]) : 20);
+    const std::size_t max_in_flight = argc > 3 ? static_cast<std::size_t>(std::atoi(argv[3])) : 32;
+    const std::string token = "123456:benchmark";
+    const std::string text = "⏰ Напоминание: Позвонить в сервис";
+
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    {
+        std::cout << "messages: " << messages << ", round trip: " << delay.count()
+                  << " ms, in flight: " << max_in_flight << "\n";
+        std::cout << std::left << std::setw(22) << "client"
+                  << std::right << std::setw(12) << "seconds"
+                  << std::setw(10) << "failed"
+                  << std::setw(14) << "connections" << "\n";
+
+        {
+            LocalHttpServer server(delay);
+            MessageSenderOptions options;
+            options.api_base_url = server.base_url();
+            MessageSender sender(token, options);
+
+            int failed = 0;
+            auto start = BenchClock::now();
+            for (int i = 0; i < messages; ++i) {
+                if (!sender.send(std::to_string(100 + i), text).ok()) {
+                    ++failed;
+                }
+            }
+            report("MessageSender", BenchClock::now() - start, failed, server.connections());
+        }
+        {
+            LocalHttpServer server(delay);
+            MessageSenderOptions options;
+            options.api_base_url = server.base_url();
+            MessageSender sender(token, options);
+            AsyncSender async(sender, max_in_flight);
+
+            int failed = 0;
+            auto start = BenchClock::now();
+            std::vector<std::future<SendResult>> results;
+            results.reserve(messages);
+            for (int i = 0; i < messages; ++i) {
+                results.push_back(async.send(std::to_string(100 + i), text));
+            }
+            for (auto& result : results) {
+                if (!result.get().ok()) {
+                    ++failed;
+                }
+            }
+            report("AsyncSender", BenchClock::now() - start, failed, server.connections());
+        }
+    }
+    curl_global_cleanup();
+    return 0;
+}
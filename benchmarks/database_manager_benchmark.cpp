@@ -0,0 +1,140 @@
+/**
+ * @file database_manager_benchmark.cpp
+ * @brief Compares the cached-statement DatabaseManager write path with the old prepare-per-call path
+ *
+ * Usage: database_manager_benchmark [iterations]
+ */
+#include "database_manager.hpp"
+#include "task.hpp"
+#include <sqlite3.h>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+using BenchClock = std::chrono::steady_clock;
+
+double opsPerSecond(int iterations, const std::function<void(int)>& body) {
+    auto start = BenchClock::now();
+    for (int i = 0; i < iterations; ++i) {
+        body(i);
+    }
+    std::chrono::duration<double> elapsed = BenchClock::now() - start;
+    return iterations / elapsed.count();
+}
+
+void report(const std::string& name, double before, double after) {
+    std::cout << std::left << std::setw(12) << name
+              << std::right << std::fixed << std::setprecision(0)
+              << std::setw(14) << before
+              << std::setw(14) << after
+              << std::setw(10) << std::setprecision(2) << (after / before) << "x\n";
+}
+
+/**
+ * @brief Raw connection reproducing the pre-cache behaviour: build SQL, prepare, bind, step, finalize
+ */
+class UncachedConnection {
+public:
+    UncachedConnection() {
+        if (sqlite3_open(":memory:", &db_) != SQLITE_OK) {
+            throw std::runtime_error("Cannot open benchmark database");
+        }
+        exec("CREATE TABLE tasks (id TEXT PRIMARY KEY, type INTEGER NOT NULL, status INTEGER NOT NULL DEFAULT 0, "
+             "title TEXT NOT NULL, description TEXT, created_at INTEGER, deadline INTEGER, priority INTEGER, "
+             "base_interval_seconds INTEGER, end_date INTEGER, last_execution INTEGER, next_execution INTEGER);");
+        exec("CREATE TABLE logs (timestamp DATETIME DEFAULT CURRENT_TIMESTAMP, action_type TEXT, task_id TEXT, message TEXT);");
+    }
+
+    ~UncachedConnection() {
+        sqlite3_close(db_);
+    }
+
+    void saveTask(const Task& task, const std::string& table_name) {
+        run("INSERT INTO " + table_name + " VALUES (?,?,?,?,?,?,?,?,?,?,?,?);", task);
+    }
+
+    void updateTask(const Task& task, const std::string& table_name) {
+        run("UPDATE " + table_name + " SET "
+            "type=?2,status=?3,title=?4,description=?5,"
+            "deadline=?7,priority=?8,base_interval_seconds=?9,"
+            "end_date=?10,last_execution=?11,next_execution=?12 "
+            "WHERE id=?1;", task);
+    }
+
+    void logAction(const std::string& action_type, const std::string& task_id, const std::string& message) {
+        const std::string sql = "INSERT INTO logs (action_type, task_id, message) VALUES (?, ?, ?);";
+        sqlite3_stmt* stmt = nullptr;
+        sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
+        sqlite3_bind_text(stmt, 1, action_type.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, task_id.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 3, message.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+    }
+
+private:
+    void exec(const char* sql) {
+        if (sqlite3_exec(db_, sql, nullptr, nullptr, nullptr) != SQLITE_OK) {
+            throw std::runtime_error(sqlite3_errmsg(db_));
+        }
+    }
+
+    void run(const std::string& sql, const Task& task) {
+        sqlite3_stmt* stmt = nullptr;
+        sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
+        sqlite3_bind_text(stmt, 1, task.get_id().c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 2, static_cast<int>(task.get_type()));
+        sqlite3_bind_int(stmt, 3, static_cast<int>(task.get_status()));
+        sqlite3_bind_text(stmt, 4, task.get_title().c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 5, task.get_description().c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 6, QDateTime::currentSecsSinceEpoch());
+        sqlite3_bind_null(stmt, 7);
+        sqlite3_bind_null(stmt, 8);
+        sqlite3_bind_int(stmt, 9, task.get_interval().count() * 3600);
+        sqlite3_bind_null(stmt, 10);
+        sqlite3_bind_null(stmt, 11);
+        sqlite3_bind_null(stmt, 12);
+        sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+    }
+
+    sqlite3* db_ = nullptr;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+    Task task("Benchmark task", "Reminder payload", Task::Type::OneTime);
+
+    UncachedConnection uncached;
+    uncached.saveTask(task, "tasks");
+
+    DatabaseOptions options;
+    options.async_log = false;  // measure the synchronous INSERT, not the queue
+    DatabaseManager db(":memory:", options);
+    db.saveTask(task, "tasks");
+
+    std::cout << "iterations: " << iterations << " (in-memory database, ops/sec)\n";
+    std::cout << std::left << std::setw(12) << "operation"
+              << std::right << std::setw(14) << "uncached"
+              << std::setw(14) << "cached"
+              << std::setw(11) << "speedup\n";
+
+    report("updateTask",
+        opsPerSecond(iterations, [&](int) { uncached.updateTask(task, "tasks"); }),
+        opsPerSecond(iterations, [&](int) { db.updateTask(task, "tasks"); }));
+
+    report("logAction",
+        opsPerSecond(iterations, [&](int) { uncached.logAction("EDIT", task.get_id(), "Изменена задача"); }),
+        opsPerSecond(iterations, [&](int) { db.logAction("EDIT", task.get_id(), "Изменена задача"); }));
+
+    return 0;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file local_http_server.hpp
+ * @brief Minimal keep-alive HTTP/1.1 stand-in for the Bot API, used by the network benchmarks
+ *
+ * Every request is answered with {"ok":true,...} after an optional delay that simulates
+ * the round trip to api.telegram.org. Plain HTTP only: the benchmarks measure connection
+ * reuse and concurrency, TLS setup would only widen the gap.
+ */
+#ifndef LOCAL_HTTP_SERVER_HPP
+#define LOCAL_HTTP_SERVER_HPP
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+class LocalHttpServer {
+public:
+    explicit LocalHttpServer(std::chrono::milliseconds delay = std::chrono::milliseconds(0)) : delay_(delay) {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd_ < 0) {
+            throw std::runtime_error("socket() failed");
+        }
+        int yes = 1;
+        ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(listen_fd_, 512) < 0) {
+            ::close(listen_fd_);
+            throw std::runtime_error("bind()/listen() failed");
+        }
+        socklen_t len = sizeof(addr);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+
+        accept_thread_ = std::thread([this] { acceptLoop(); });
+    }
+
+    ~LocalHttpServer() {
+        running_ = false;
+        accept_thread_.join();
+        ::close(listen_fd_);
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    LocalHttpServer(const LocalHttpServer&) = delete;
+    LocalHttpServer& operator=(const LocalHttpServer&) = delete;
+
+    std::string base_url() const {
+        return "http://127.0.0.1:" + std::to_string(port_);
+    }
+
+    std::size_t connections() const noexcept { return connections_.load(); }
+    std::size_t requests() const noexcept { return requests_.load(); }
+
+private:
+    void acceptLoop() {
+        while (running_) {
+            pollfd pfd{listen_fd_, POLLIN, 0};
+            if (::poll(&pfd, 1, 50) <= 0) {
+                continue;
+            }
+            int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) {
+                continue;
+            }
+            int yes = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+            ++connections_;
+            std::lock_guard<std::mutex> lock(mutex_);
+            workers_.emplace_back([this, fd] { serve(fd); });
+        }
+    }
+
+    void serve(int fd) {
+        std::string buffer;
+        char chunk[4096];
+        while (running_) {
+            std::size_t header_end;
+            while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+                if (!readSome(fd, chunk, sizeof(chunk), buffer)) {
+                    ::close(fd);
+                    return;
+                }
+            }
+            std::size_t body_length = contentLength(buffer.substr(0, header_end));
+            while (buffer.size() < header_end + 4 + body_length) {
+                if (!readSome(fd, chunk, sizeof(chunk), buffer)) {
+                    ::close(fd);
+                    return;
+                }
+            }
+            buffer.erase(0, header_end + 4 + body_length);
+            ++requests_;
+
+            if (delay_.count() > 0) {
+                std::this_thread::sleep_for(delay_);
+            }
+            static const std::string body = R"({"ok":true,"result":{"message_id":1}})";
+            const std::string response =
+                "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " +
+                std::to_string(body.size()) + "\r\n\r\n" + body;
+            if (::send(fd, response.data(), response.size(), MSG_NOSIGNAL) < 0) {
+                break;
+            }
+        }
+        ::close(fd);
+    }
+
+    bool readSome(int fd, char* chunk, std::size_t size, std::string& buffer) {
+        while (running_) {
+            pollfd pfd{fd, POLLIN, 0};
+            int ready = ::poll(&pfd, 1, 50);
+            if (ready == 0) {
+                continue;
+            }
+            if (ready < 0) {
+                return false;
+            }
+            ssize_t n = ::recv(fd, chunk, size, 0);
+            if (n <= 0) {
+                return false;
+            }
+            buffer.append(chunk, static_cast<std::size_t>(n));
+            return true;
+        }
+        return false;
+    }
+
+    static std::size_t contentLength(const std::string& headers) {
+        for (const char* name : {"Content-Length:", "content-length:"}) {
+            std::size_t pos = headers.find(name);
+            if (pos != std::string::npos) {
+                return static_cast<std::size_t>(std::strtoul(headers.c_str() + pos + 15, nullptr, 10));
+            }
+        }
+        return 0;
+    }
+
+    std::chrono::milliseconds delay_;
+    int listen_fd_ = -1;
+    unsigned short port_ = 0;
+    std::atomic<bool> running_{true};
+    std::atomic<std::size_t> connections_{0};
+    std::atomic<std::size_t> requests_{0};
+    std::thread accept_thread_;
+    std::mutex mutex_;
+    std::vector<std::thread> workers_;
+};
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * @file message_sender_benchmark.cpp
+ * @brief Compares the keep-alive MessageSender with the previous handle-per-message send path
+ *
+ * Both run against a local HTTP stand-in of the Bot API.
+ * Usage: message_sender_benchmark [messages]
+ */
+#include "message_sender.hpp"
+#include "curl_handle.hpp"
+#include "local_http_server.hpp"
+#include <curl/curl.h>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+
+using BenchClock = std::chrono::steady_clock;
+
+size_t discardBody(char*, size_t size, size_t nmemb, void*) {
+    return size * nmemb;
+}
+
+/**
+ * @brief The previous TelegramBot::send_direct_message: a new easy handle, connection and DNS lookup per message
+ */
+bool sendWithNewHandle(const std::string& base_url, const std::string& token, const std::string& chat_id, const std::string& text) {
+    CurlHandle curl;
+    std::string url = base_url + "/bot" + token + "/sendMessage";
+
+    char* encoded_text = curl_easy_escape(curl, text.c_str(), text.length());
+    char* encoded_chat_id = curl_easy_escape(curl, chat_id.c_str(), chat_id.length());
+    std::string params = "chat_id=" + std::string(encoded_chat_id) + "&text=" + std::string(encoded_text);
+    curl_free(encoded_text);
+    curl_free(encoded_chat_id);
+
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, params.c_str());
+    curl_easy_setopt(curl, CURLOPT_POST, 1L);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discardBody);
+    return curl_easy_perform(curl) == CURLE_OK;
+}
+
+double sendsPerSecond(int messages, const std::function<bool(int)>& send) {
+    int failed = 0;
+    auto start = BenchClock::now();
+    for (int i = 0; i < messages; ++i) {
+        if (!send(i)) {
+            ++failed;
+        }
+    }
+    std::chrono::duration<double> elapsed = BenchClock::now() - start;
+    if (failed > 0) {
+        std::cerr << failed << " sends failed\n";
+    }
+    return messages / elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int messages = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const std::string token = "123456:benchmark";
+    const std::string text = "⏰ Напоминание: Позвонить в сервис";
+
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    {
+        std::cout << "messages: " << messages << " (local HTTP stand-in, sends/sec)\n";
+        std::cout << std::left << std::setw(22) << "client"
+                  << std::right << std::setw(14) << "sends/sec"
+                  << std::setw(14) << "connections" << "\n";
+
+        {
+            LocalHttpServer server;
+            double rate = sendsPerSecond(messages, [&](int) {
+                return sendWithNewHandle(server.base_url(), token, "100", text);
+            });
+            std::cout << std::left << std::setw(22) << "handle per message"
+                      << std::right << std::fixed << std::setprecision(0) << std::setw(14) << rate
+                      << std::setw(14) << server.connections() << "\n";
+        }
+        {
+            LocalHttpServer server;
+            MessageSenderOptions options;
+            options.api_base_url = server.base_url();
+            MessageSender sender(token, options);
+            double rate = sendsPerSecond(messages, [&](int) {
+                return sender.send("100", text).ok();
+            });
+            std::cout << std::left << std::setw(22) << "MessageSender"
+                      << std::right << std::fixed << std::setprecision(0) << std::setw(14) << rate
+                      << std::setw(14) << server.connections() << "\n";
+        }
+    }
+    curl_global_cleanup();
+    return 0;
+}
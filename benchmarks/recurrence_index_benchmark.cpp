@@ -0,0 +1,114 @@
+/**
+ * @file recurrence_index_benchmark.cpp
+ * @brief Finds the due recurring tasks by walking Task objects and through RecurrenceIndex
+ *
+ * The object loop calls Task::next_execution_time() on every element of a std::vector<Task>,
+ * as a scan of the resident tasks does today. The index columns are built once from the same
+ * tasks; building them is not timed. Every run must report the same number of due tasks.
+ *
+ * Usage: recurrence_index_benchmark [tasks] [rounds]
+ */
+#include "recurrence_index.hpp"
+#include "task.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using BenchClock = std::chrono::steady_clock;
+
+// Best of `rounds`, in milliseconds per pass
+double bestPass(int rounds, const std::function<std::size_t()>& pass, std::size_t& due) {
+    double best = 0;
+    for (int round = 0; round < rounds; ++round) {
+        auto start = BenchClock::now();
+        due = pass();
+        std::chrono::duration<double, std::milli> elapsed = BenchClock::now() - start;
+        if (round == 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+
+void report(const std::string& name, double ms, double baseline, std::size_t due) {
+    std::cout << std::left << std::setw(16) << name
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << ms
+              << std::setw(10) << (baseline / ms) << "x"
+              << std::setw(12) << due << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t count = argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 1000000;
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    const auto now = std::chrono::system_clock::from_time_t(1700000000);
+    const std::int64_t now_seconds = std::chrono::system_clock::to_time_t(now);
+
+    // Daily to weekly tasks executed within the last week; a quarter end within the next week
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<int> hours(24, 24 * 7);
+    std::uniform_int_distribution<int> ago(0, 24 * 7 * 3600);
+    std::vector<Task> tasks;
+    tasks.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        tasks.emplace_back("Привычка " + std::to_string(i), "", Task::Type::Recurring, QDateTime(), std::chrono::hours(hours(rng)));
+        tasks.back().mark_execution(now - std::chrono::seconds(ago(rng)));
+        if (i % 4 == 0) {
+            tasks.back().set_end_date(QDateTime::fromSecsSinceEpoch(now_seconds + ago(rng)));
+        }
+    }
+
+    RecurrenceIndex index;
+    index.reserve(count);
+    for (const auto& task : tasks) {
+        index.add(task, now);
+    }
+    std::vector<std::int64_t> next(index.size());
+    std::vector<std::uint64_t> due((index.size() + 63) / 64);
+
+    std::cout << "tasks: " << count << ", indexed: " << index.size()
+              << " (best of " << rounds << ", ms per pass)\n";
+    std::cout << std::left << std::setw(16) << "method"
+              << std::right << std::setw(12) << "ms"
+              << std::setw(11) << "speedup"
+              << std::setw(12) << "due" << "\n";
+
+    std::size_t found = 0;
+    const double objects = bestPass(rounds, [&]() {
+        std::size_t due_tasks = 0;
+        for (const auto& task : tasks) {
+            auto fire = task.next_execution_time(now);
+            due_tasks += fire && *fire <= now;
+        }
+        return due_tasks;
+    }, found);
+    report("Task objects", objects, objects, found);
+
+    const std::pair<const char*, RecurrenceIndex::Kernel> kernels[] = {
+        {"index scalar", RecurrenceIndex::Kernel::Scalar},
+        {"index SSE4.2", RecurrenceIndex::Kernel::Sse42},
+        {"index AVX2", RecurrenceIndex::Kernel::Avx2},
+    };
+    for (const auto& [name, kernel] : kernels) {
+        if (!RecurrenceIndex::supports(kernel)) {
+            std::cout << std::left << std::setw(16) << name << "   not supported by this CPU\n";
+            continue;
+        }
+        const double ms = bestPass(rounds, [&, kernel = kernel]() {
+            return index.evaluate(now_seconds, next, due, kernel);
+        }, found);
+        report(name, ms, objects, found);
+    }
+    return 0;
+}
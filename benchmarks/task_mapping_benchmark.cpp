@@ -0,0 +1,235 @@
+/**
+ * @file task_mapping_benchmark.cpp
+ * @brief Counts heap allocations per saved and per loaded task
+ *
+ * Both C++ (operator new) and SQLite (sqlite3_malloc/realloc) allocations are counted.
+ * The "copying" column reproduces the previous bind/map code (string copies, SQLITE_TRANSIENT,
+ * a fresh Task per row) on statements prepared once, so only the copying differs.
+ *
+ * Usage: task_mapping_benchmark [rows]
+ */
+#include "database_manager.hpp"
+#include "task.hpp"
+#include <sqlite3.h>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<std::size_t> g_allocations{0};
+
+sqlite3_mem_methods g_sqlite_default;
+
+void* countingSqliteMalloc(int size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return g_sqlite_default.xMalloc(size);
+}
+
+void* countingSqliteRealloc(void* ptr, int size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return g_sqlite_default.xRealloc(ptr, size);
+}
+
+/**
+ * @brief Route SQLite's allocator through the counter; must run before SQLite is initialized
+ */
+void installSqliteCounter() {
+    sqlite3_config(SQLITE_CONFIG_GETMALLOC, &g_sqlite_default);
+    sqlite3_mem_methods counting = g_sqlite_default;
+    counting.xMalloc = countingSqliteMalloc;
+    counting.xRealloc = countingSqliteRealloc;
+    if (sqlite3_config(SQLITE_CONFIG_MALLOC, &counting) != SQLITE_OK) {
+        throw std::runtime_error("Cannot install the SQLite allocation counter");
+    }
+}
+
+double allocationsPerRow(std::size_t rows, const std::function<void()>& body) {
+    const std::size_t before = g_allocations.load(std::memory_order_relaxed);
+    body();
+    return static_cast<double>(g_allocations.load(std::memory_order_relaxed) - before) / rows;
+}
+
+void report(const std::string& name, double before, double after) {
+    std::cout << std::left << std::setw(12) << name
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << before
+              << std::setw(12) << after << "\n";
+}
+
+/**
+ * @brief Previous DatabaseManager bind and map code on its own connection
+ */
+class CopyingConnection {
+public:
+    CopyingConnection() {
+        if (sqlite3_open(":memory:", &db_) != SQLITE_OK) {
+            throw std::runtime_error("Cannot open benchmark database");
+        }
+        exec("CREATE TABLE tasks (id TEXT PRIMARY KEY, type INTEGER NOT NULL, status INTEGER NOT NULL DEFAULT 0, "
+             "title TEXT NOT NULL, description TEXT, created_at INTEGER, deadline INTEGER, priority INTEGER, "
+             "base_interval_seconds INTEGER, end_date INTEGER, last_execution INTEGER, next_execution INTEGER);");
+        exec("CREATE INDEX idx_tasks_status_type ON tasks(status, type);");
+        exec("CREATE INDEX idx_tasks_deadline ON tasks(status, deadline);");
+        exec("CREATE INDEX idx_tasks_next_execution ON tasks(status, next_execution);");
+        insert_ = prepare("INSERT INTO tasks VALUES (?,?,?,?,?,?,?,?,?,?,?,?);");
+        update_ = prepare("UPDATE tasks SET type=?2,status=?3,title=?4,description=?5,"
+                          "deadline=?7,priority=?8,base_interval_seconds=?9,"
+                          "end_date=?10,last_execution=?11,next_execution=?12 WHERE id=?1;");
+        select_ = prepare("SELECT * FROM tasks;");
+    }
+
+    ~CopyingConnection() {
+        sqlite3_finalize(insert_);
+        sqlite3_finalize(update_);
+        sqlite3_finalize(select_);
+        sqlite3_close(db_);
+    }
+
+    void saveTask(const Task& task) {
+        run(insert_, task);
+    }
+
+    void updateTask(const Task& task) {
+        run(update_, task);
+    }
+
+    std::size_t forEachTask(const std::function<void(const Task&)>& visitor) {
+        std::size_t rows = 0;
+        while (sqlite3_step(select_) == SQLITE_ROW) {
+            Task task;
+            task.set_id(reinterpret_cast<const char*>(sqlite3_column_text(select_, 0)));
+            task.set_type(static_cast<Task::Type>(sqlite3_column_int(select_, 1)));
+            task.set_status(static_cast<Task::Status>(sqlite3_column_int(select_, 2)));
+            task.set_title(reinterpret_cast<const char*>(sqlite3_column_text(select_, 3)));
+            if (sqlite3_column_type(select_, 4) != SQLITE_NULL) {
+                task.set_description(reinterpret_cast<const char*>(sqlite3_column_text(select_, 4)));
+            }
+            visitor(task);
+            ++rows;
+        }
+        sqlite3_reset(select_);
+        return rows;
+    }
+
+private:
+    void run(sqlite3_stmt* stmt, const Task& task) {
+        sqlite3_bind_text(stmt, 1, task.get_id().c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 2, static_cast<int>(task.get_type()));
+        sqlite3_bind_int(stmt, 3, static_cast<int>(task.get_status()));
+        sqlite3_bind_text(stmt, 4, task.get_title().c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 5, task.get_description().c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 6, QDateTime::currentSecsSinceEpoch());
+        for (int column = 7; column <= 12; ++column) {
+            sqlite3_bind_null(stmt, column);
+        }
+        sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    }
+
+    void exec(const char* sql) {
+        if (sqlite3_exec(db_, sql, nullptr, nullptr, nullptr) != SQLITE_OK) {
+            throw std::runtime_error(sqlite3_errmsg(db_));
+        }
+    }
+
+    sqlite3_stmt* prepare(const char* sql) {
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v3(db_, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr) != SQLITE_OK) {
+            throw std::runtime_error(sqlite3_errmsg(db_));
+        }
+        return stmt;
+    }
+
+    sqlite3* db_ = nullptr;
+    sqlite3_stmt* insert_ = nullptr;
+    sqlite3_stmt* update_ = nullptr;
+    sqlite3_stmt* select_ = nullptr;
+};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t rows = argc > 1 ? static_cast<std::size_t>(std::atoi(argv[1])) : 10000;
+
+    installSqliteCounter();
+
+    // Titles and descriptions longer than the small-string buffer, as in real reminders
+    std::vector<Task> tasks;
+    tasks.reserve(rows);
+    for (std::size_t i = 0; i < rows; ++i) {
+        tasks.emplace_back("Позвонить в сервис по поводу заказа", "Уточнить сроки доставки и номер накладной", Task::Type::OneTime);
+        tasks.back().set_id(std::to_string(1700000000000 + i) + "_0001");
+    }
+
+    CopyingConnection copying;
+    DatabaseOptions options;
+    options.async_log = false;
+    DatabaseManager db(":memory:", options);
+
+    // Warm up the statement caches so only steady-state work is counted
+    copying.saveTask(tasks[0]);
+    db.saveTask(tasks[0]);
+    copying.updateTask(tasks[0]);
+    db.updateTask(tasks[0]);
+
+    // saveTask also includes the B-tree pages SQLite allocates for the new rows
+    std::cout << "rows: " << rows << " (heap allocations per task, C++ + SQLite)\n";
+    std::cout << std::left << std::setw(12) << "operation"
+              << std::right << std::setw(12) << "copying"
+              << std::setw(12) << "zero-copy" << "\n";
+
+    report("saveTask",
+        allocationsPerRow(rows - 1, [&]() {
+            for (std::size_t i = 1; i < rows; ++i) copying.saveTask(tasks[i]);
+        }),
+        allocationsPerRow(rows - 1, [&]() {
+            for (std::size_t i = 1; i < rows; ++i) db.saveTask(tasks[i]);
+        }));
+
+    report("updateTask",
+        allocationsPerRow(rows, [&]() {
+            for (const auto& task : tasks) copying.updateTask(task);
+        }),
+        allocationsPerRow(rows, [&]() {
+            for (const auto& task : tasks) db.updateTask(task);
+        }));
+
+    std::size_t checksum = 0;
+    report("forEachTask",
+        allocationsPerRow(rows, [&]() {
+            copying.forEachTask([&](const Task& task) { checksum += task.get_title_view().size(); });
+        }),
+        allocationsPerRow(rows, [&]() {
+            db.forEachTask([&](const Task& task) {
+                checksum += task.get_title_view().size();
+                return true;
+            });
+        }));
+
+    std::cout << "checksum: " << checksum << "\n";
+    return 0;
+}
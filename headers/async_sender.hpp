@@ -0,0 +1,107 @@
+#ifndef ASYNC_SENDER_HPP
+#define ASYNC_SENDER_HPP
+
+#include "curl_handle.hpp"
+#include "message_sender.hpp"
+#include <curl/curl.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class AsyncSender
+ * @brief curl_multi engine that runs many sendMessage calls concurrently on one background thread
+ *
+ * Requests are queued and at most `max_in_flight` transfers run at a time, so a burst of
+ * N messages takes about N / max_in_flight round trips instead of N. Connections and
+ * settings come from the MessageSender the engine is built on (HTTP/2 streams are
+ * multiplexed on one connection when the server supports it).
+ *
+ * Completion callbacks run on the engine thread; callers that own a QObject forward
+ * them with QMetaObject::invokeMethod (see TelegramBot::send_message_async).
+ */
+class AsyncSender {
+public:
+    using Callback = std::function<void(const SendResult&)>;
+
+    /**
+     * @param sender Source of the URL and connection settings; must outlive the engine
+     * @param max_in_flight Upper bound on concurrent transfers (at least 1)
+     * @throws std::runtime_error If the multi handle cannot be created
+     */
+    explicit AsyncSender(const MessageSender& sender, std::size_t max_in_flight = 32);
+
+    /**
+     * @brief Abort pending requests and stop the engine thread (see stop())
+     */
+    ~AsyncSender();
+
+    AsyncSender(const AsyncSender&) = delete;
+    AsyncSender& operator=(const AsyncSender&) = delete;
+
+    /**
+     * @brief Queue a message; `done` is called exactly once on the engine thread
+     */
+    void send(std::string chat_id, std::string text, Callback done);
+
+    /**
+     * @brief Queue a message and get its result as a future
+     */
+    std::future<SendResult> send(std::string chat_id, std::string text);
+
+    /**
+     * @brief Stop the engine; queued and running requests complete with CURLE_ABORTED_BY_CALLBACK
+     */
+    void stop();
+
+    /**
+     * @brief Requests queued or running
+     */
+    std::size_t pending() const noexcept;
+
+    std::size_t max_in_flight() const noexcept;
+
+private:
+    struct Request {
+        std::string chat_id;
+        std::string text;
+        Callback done;
+    };
+
+    struct Transfer {
+        CurlHandle handle;
+        std::string params;
+        SendResult result;
+        Callback done;
+    };
+
+    void run();
+    void startQueued();
+    void finishCompleted();
+    void abortAll();
+    static void complete(const Callback& done, const SendResult& result) noexcept;
+
+    const MessageSender& sender_;
+    const std::string send_url_;
+    const std::size_t max_in_flight_;
+
+    CURLM* multi_ = nullptr;
+    std::thread thread_;
+    std::atomic<bool> running_{true};
+    std::atomic<std::size_t> pending_{0};
+
+    mutable std::mutex queue_mutex_;
+    std::deque<Request> queue_;
+
+    // Touched by the engine thread only
+    std::vector<std::unique_ptr<Transfer>> in_flight_;
+    std::vector<CurlHandle> idle_handles_;
+};
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef AUDIT_LOG_WRITER_HPP
+#define AUDIT_LOG_WRITER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief One row of the `logs` table, stamped when it is enqueued
+ */
+struct LogEntry {
+    std::string action_type;
+    std::string task_id;
+    std::string message;
+    std::int64_t timestamp;     ///< Seconds since epoch (UTC)
+};
+
+/**
+ * @brief Limits of the audit log queue
+ */
+struct AuditLogOptions {
+    std::size_t capacity = 4096;                                        ///< Entries kept in memory before new ones are dropped
+    std::size_t max_batch = 256;                                        ///< Entries written per transaction at most
+    std::chrono::milliseconds flush_interval{200};                      ///< Longest time an entry waits for its batch to fill
+};
+
+/**
+ * @brief Counters describing the writer since it was started
+ */
+struct AuditLogStats {
+    std::size_t depth = 0;          ///< Entries waiting in the queue
+    std::uint64_t written = 0;      ///< Entries handed to the sink successfully
+    std::uint64_t dropped = 0;      ///< Entries rejected because the queue was full
+    std::uint64_t failed = 0;       ///< Entries lost because the sink threw
+    std::uint64_t batches = 0;      ///< Sink calls (group commits)
+};
+
+/**
+ * @class AuditLogWriter
+ * @brief Bounded multi-producer queue of log entries drained by one background thread
+ *
+ * Producers only take a short lock to append; the background thread groups entries
+ * into batches by count or by time window and hands each batch to the sink, which is
+ * expected to write it in a single transaction. Pending entries are written on stop().
+ */
+class AuditLogWriter {
+public:
+    using Sink = std::function<void(const std::vector<LogEntry>&)>;
+
+    /**
+     * @param sink Writes one batch; exceptions are counted as failed entries
+     * @param options Queue capacity and batching limits
+     */
+    explicit AuditLogWriter(Sink sink, const AuditLogOptions& options = AuditLogOptions());
+
+    /**
+     * @brief Stop the thread after writing every pending entry
+     */
+    ~AuditLogWriter();
+
+    AuditLogWriter(const AuditLogWriter&) = delete;
+    AuditLogWriter& operator=(const AuditLogWriter&) = delete;
+
+    /**
+     * @brief Queue an entry without touching the disk
+     * @return False if the queue is full or stopped and the entry was dropped
+     */
+    bool enqueue(LogEntry entry);
+
+    /**
+     * @brief Block until every entry enqueued before the call has been written (or failed)
+     */
+    void flush();
+
+    /**
+     * @brief Write the pending entries and join the background thread (idempotent)
+     */
+    void stop();
+
+    AuditLogStats stats() const;
+
+private:
+    void run();
+
+    Sink sink_;
+    AuditLogOptions options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;          ///< Signals the writer thread
+    std::condition_variable done_;          ///< Signals flush() waiters
+    std::deque<LogEntry> queue_;
+    bool stopping_ = false;
+    bool flush_requested_ = false;
+
+    std::uint64_t enqueued_ = 0;            ///< Sequence number of the last accepted entry
+    std::uint64_t completed_ = 0;           ///< Entries written or failed so far
+    AuditLogStats stats_;
+
+    std::thread thread_;
+};
+
+#endif
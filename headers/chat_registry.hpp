@@ -0,0 +1,69 @@
+#ifndef CHAT_REGISTRY_HPP
+#define CHAT_REGISTRY_HPP
+
+#include <cstddef>
+#include <functional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @class ChatRegistry
+ * @brief In-memory copy of the `telegram_chats` table, kept in step with every write to it
+ *
+ * Loaded once when the database opens; afterwards checking whether a chat is registered
+ * is one hash lookup on a string_view, with no allocation and no SQLite call. Readers
+ * share a lock, so commands from the polling thread and the GUI can check concurrently.
+ */
+class ChatRegistry {
+public:
+    /**
+     * @brief Add a chat; false if it was already registered
+     * @param persist Writes the chat to the table; runs under the exclusive lock, so a concurrent
+     *        insert or clear cannot interleave between the table write and the memory update.
+     *        If it throws, the registry is left unchanged.
+     */
+    bool insert(std::string_view chat_id, const std::function<void()>& persist = nullptr);
+
+    /**
+     * @brief Replace the contents, e.g. with the rows read from the table
+     */
+    void assign(std::vector<std::string> chat_ids);
+
+    void clear() noexcept;
+
+    /**
+     * @brief Remove every chat after `persist` emptied the table, under the same lock (see insert)
+     */
+    void clear(const std::function<void()>& persist);
+
+    bool contains(std::string_view chat_id) const;
+
+    /**
+     * @brief Chats in registration order
+     */
+    std::vector<std::string> snapshot() const;
+
+    /**
+     * @brief Earliest registered chat, empty if there is none
+     */
+    std::string first() const;
+
+    std::size_t size() const;
+
+private:
+    struct Hash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view chat_id) const noexcept {
+            return std::hash<std::string_view>{}(chat_id);
+        }
+    };
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_set<std::string, Hash, std::equal_to<>> chats_;
+    std::vector<std::string> order_;  ///< Same chats in registration order, as SELECT returns them
+};
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef COMMAND_ROUTER_HPP
+#define COMMAND_ROUTER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief A bot command split out of a message; views into the message text
+ */
+struct CommandContext {
+    std::string_view chat_id;
+    std::string_view command;  ///< "/add_task", without any "@botname" suffix
+    std::string_view args;     ///< Text after the command, surrounding whitespace trimmed
+};
+
+/**
+ * @brief Call counters and latency of one command
+ */
+struct CommandMetrics {
+    std::uint64_t calls = 0;     ///< Handler runs
+    std::uint64_t rejected = 0;  ///< Stopped by middleware
+    std::chrono::nanoseconds total{0};
+    std::chrono::nanoseconds max{0};
+
+    std::chrono::nanoseconds mean() const noexcept;
+};
+
+/**
+ * @class CommandRouter
+ * @brief Registry of bot commands: one hash lookup per message instead of a chain of prefix checks
+ *
+ * The command token is looked up in a hash map keyed by name (heterogeneous lookup,
+ * so no string is built for the key). A command may carry middleware that runs first
+ * and can stop it, e.g. a registration check. Handler latency is recorded per command.
+ *
+ * Not thread-safe: the bot registers commands once and dispatches on its own thread.
+ */
+class CommandRouter {
+public:
+    using Handler = std::function<void(const CommandContext&)>;
+
+    /**
+     * @brief Runs before the handler; returns false to stop (and is responsible for any reply)
+     */
+    using Middleware = std::function<bool(const CommandContext&)>;
+
+    /**
+     * @brief Register a command
+     * @param name Command with the leading slash, e.g. "/start"
+     * @throws std::invalid_argument If the name is malformed or already registered
+     */
+    void add(std::string name, Handler handler, std::vector<Middleware> middleware = {});
+
+    /**
+     * @brief Called for messages that are not a registered command
+     */
+    void set_fallback(Handler handler);
+
+    /**
+     * @brief Route one message
+     * @return true if the text was a registered command (whether or not middleware let it run)
+     */
+    bool dispatch(std::string_view chat_id, std::string_view text);
+
+    /**
+     * @brief Split "/cmd@bot args" into command and arguments; nothing if the text is not a command
+     */
+    static std::optional<CommandContext> parse(std::string_view chat_id, std::string_view text);
+
+    /**
+     * @brief Split arguments on `delimiter` into at most `max_parts` trimmed views; the last part keeps the rest
+     */
+    static std::vector<std::string_view> split_args(std::string_view args, char delimiter,
+                                                    std::size_t max_parts = static_cast<std::size_t>(-1));
+
+    static std::string_view trim(std::string_view s) noexcept;
+
+    /**
+     * @brief Metrics of one command, nothing if it is not registered
+     */
+    std::optional<CommandMetrics> metrics(std::string_view name) const;
+
+    /**
+     * @brief Registered command names in registration order
+     */
+    const std::vector<std::string>& commands() const noexcept;
+
+private:
+    struct Entry {
+        Handler handler;
+        std::vector<Middleware> middleware;
+        CommandMetrics metrics;
+    };
+
+    struct NameHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view name) const noexcept {
+            return std::hash<std::string_view>{}(name);
+        }
+    };
+
+    std::unordered_map<std::string, Entry, NameHash, std::equal_to<>> entries_;
+    std::vector<std::string> order_;
+    Handler fallback_;
+};
+
+#endif
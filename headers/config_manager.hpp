@@ -2,6 +2,8 @@
 #define CONFIG_MANAGER_HPP
 
 #include <string>
+#include <chrono>
+#include <vector>
 #include <stdexcept>
 
 class ConfigManager {
@@ -11,9 +13,68 @@ public:
     std::string get_bot_token() const;
     std::string get_db_path() const;
 
+    /**
+     * @brief [Telegram] ApiUrl: Bot API base URL, e.g. a local stand-in or proxy (default "https://api.telegram.org")
+     */
+    std::string get_telegram_api_url() const;
+
+    /**
+     * @brief [Telegram] MaxInFlight: concurrent sendMessage requests of the async sender (default 32)
+     */
+    int get_telegram_max_in_flight() const;
+
+    /**
+     * @brief [Telegram] DeadlineLeads: how long before a deadline to remind, e.g. "24h, 1h, 10m"
+     *        (units s, m, h, d; default "24h, 1h, 10m"; empty disables deadline reminders)
+     * @throws std::runtime_error On a malformed entry
+     */
+    std::vector<std::chrono::seconds> get_deadline_leads() const;
+
+    /**
+     * @brief [Telegram] Mode in lower case: "polling" (default) or "webhook"
+     * @throws std::runtime_error On any other value
+     */
+    std::string get_telegram_mode() const;
+
+    /**
+     * @brief [Telegram] WebhookAddress: interface the webhook listener binds (default "127.0.0.1")
+     */
+    std::string get_webhook_address() const;
+
+    /**
+     * @brief [Telegram] WebhookPort: listener port (default 8443)
+     */
+    int get_webhook_port() const;
+
+    /**
+     * @brief [Telegram] WebhookPath: accepted request path (default "/telegram/webhook")
+     */
+    std::string get_webhook_path() const;
+
+    /**
+     * @brief [Telegram] WebhookSecret: secret_token given to setWebhook, empty disables the check
+     */
+    std::string get_webhook_secret() const;
+
+    /**
+     * @brief [Database] JournalMode in upper case: "WAL" enables write-ahead logging (default "DELETE")
+     */
+    std::string get_db_journal_mode() const;
+
+    /**
+     * @brief [Database] ReadPoolSize: read-only connections used in WAL mode (default 0)
+     */
+    int get_db_read_pool_size() const;
+
+    /**
+     * @brief [Database] Synchronous: PRAGMA synchronous level (default "FULL")
+     */
+    std::string get_db_synchronous() const;
+
 private:
     std::string config_path_;
     std::string read_key(const std::string& section, const std::string& key) const;
+    std::string read_key_or(const std::string& section, const std::string& key, const std::string& fallback) const;
 };
 
 #endif
\ No newline at end of file
@@ -24,4 +24,27 @@ private:
     CURL* handle_;
 };
 
+/**
+ * @brief Owning wrapper of a CURLM multi handle, the counterpart of CurlHandle
+ */
+class CurlMultiHandle {
+public:
+    CurlMultiHandle();
+
+    ~CurlMultiHandle();
+
+    CurlMultiHandle(const CurlMultiHandle&) = delete;
+    CurlMultiHandle& operator=(const CurlMultiHandle&) = delete;
+
+    CurlMultiHandle(CurlMultiHandle&& other) noexcept;
+    CurlMultiHandle& operator=(CurlMultiHandle&& other) noexcept;
+
+    operator CURLM*() const noexcept;
+
+private:
+    void cleanup() noexcept;
+
+    CURLM* handle_;
+};
+
 #endif
\ No newline at end of file
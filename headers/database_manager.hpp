@@ -4,11 +4,35 @@
 #include <sqlite3.h>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <stdexcept>
 #include <functional>
 #include <utility>
+#include <memory>
+#include <optional>
+#include <span>
+#include <cstddef>
+#include <chrono>
+#include <mutex>
 #include "task.hpp"
 #include "task_template.hpp"
+#include "statement_cache.hpp"
+#include "read_connection_pool.hpp"
+#include "audit_log_writer.hpp"
+#include "task_statistics.hpp"
+#include "chat_registry.hpp"
+
+/**
+ * @brief Connection settings, usually taken from the [Database] section of config.ini
+ */
+struct DatabaseOptions {
+    bool wal = false;                   ///< Open the database in WAL journal mode
+    std::size_t read_pool_size = 0;     ///< Read-only connections used alongside the writer (WAL only)
+    std::string synchronous = "FULL";   ///< PRAGMA synchronous level: OFF, NORMAL, FULL or EXTRA
+    int busy_timeout_ms = 5000;         ///< How long a connection waits for a lock held by another one
+    bool async_log = true;              ///< Write logAction() rows from a background thread in batches
+    AuditLogOptions log;                ///< Queue limits of the background log writer
+};
 
 /**
  * @class DatabaseManager
@@ -16,52 +40,466 @@
  */
 class DatabaseManager {
 public:
+    ///< How a bulk write reacts to a failing row
+    enum class BatchMode {
+        AllOrNothing,   ///< Roll back the whole batch and throw on the first failing row
+        PerRow          ///< Commit the rows that succeeded and report the failed ones
+    };
+
+    /**
+     * @brief Row callback for streaming reads; return false to stop early
+     * @note The Task is reused for the next row, copy it to keep it
+     */
+    using TaskVisitor = std::function<bool(const Task&)>;
+
+    /**
+     * @brief Owner chat a task query is restricted to; std::nullopt covers every task
+     */
+    using OwnerFilter = std::optional<std::string_view>;
+
+    /**
+     * @brief Kind of write reported to task observers
+     */
+    enum class TaskChange {
+        Saved,
+        Updated,
+        Deleted
+    };
+
+    /**
+     * @brief Called after a write to the `tasks` table is committed; `task` is null for deletions
+     * @note Runs on the writing thread with the writer lock held: keep it short, hand work off
+     *       to another thread and do not add or remove observers from inside it
+     */
+    using TaskObserver = std::function<void(TaskChange change, std::string_view id, const Task* task)>;
+
+    /**
+     * @brief Outcome of a bulk write
+     */
+    struct BatchResult {
+        std::size_t written = 0;                                   ///< Rows whose statement succeeded
+        std::vector<std::pair<std::size_t, std::string>> errors;   ///< (index in the input, error message)
+
+        bool ok() const noexcept { return errors.empty(); }
+    };
+
+    /**
+     * @brief Deadline reminder taken from `scheduled_events`, with the task fields the message needs
+     */
+    struct DeadlineEvent {
+        std::string task_id;
+        std::string title;
+        std::string owner_chat_id;           ///< Empty for tasks created in the GUI
+        std::chrono::seconds lead{0};        ///< How long before the deadline the event fires
+        PeriodicTracker::TimePoint deadline;
+    };
+
+    /**
+     * @brief Task removed by purgeCompletedTasks()
+     */
+    struct PurgedTask {
+        std::string id;
+        std::string title;
+        std::string owner_chat_id;
+    };
+
     /**
      * @brief Initializes the database connection and creates required tables.
      * @param db_path Path to the SQLite database file.
+     * @param options Journal mode, synchronous level and read pool size.
      * @throws std::runtime_error If connection fails.
+     * @throws std::invalid_argument If options.synchronous is not a known level.
      */
-    explicit DatabaseManager(const std::string& db_path);
+    explicit DatabaseManager(const std::string& db_path, const DatabaseOptions& options = DatabaseOptions());
 
     /**
      * @brief Destroy the Database Manager object
      */
     ~DatabaseManager();
 
+    /**
+     * @brief Bring the schema up to date (see SchemaMigrator); does nothing on a current database
+     * @throws std::runtime_error If a migration fails; that migration is rolled back
+     */
     void initialize();
 
+    /**
+     * @brief Schema version stored in the database (`PRAGMA user_version`)
+     */
+    int schemaVersion() const;
+
+    /**
+     * @brief Append a row to `logs`
+     *
+     * With DatabaseOptions::async_log the row is only queued and written later in a batch,
+     * so the caller never waits for the disk. Rows are dropped when the queue is full.
+     */
     void logAction(
         const std::string& action_type,
         const std::string& task_id,
         const std::string& message
     );
 
+    /**
+     * @brief Wait until every queued log row has been written
+     */
+    void flushLogs();
+
+    /**
+     * @brief Queue depth and drop/write counters of the background log writer
+     */
+    AuditLogStats logStats() const;
+
     void saveTask(const Task& task, const std::string& table_name = "tasks");
     void updateTask(const Task& task, const std::string& table_name = "tasks");
     void deleteTask(const std::string& id, const std::string& table_name = "tasks");
-    Task getTaskById(const std::string& id);
+
+    /**
+     * @brief Delete every completed one-time and deadline task with one DELETE statement
+     * @return The removed tasks, for one summary message per chat
+     */
+    std::vector<PurgedTask> purgeCompletedTasks();
+
+    /**
+     * @brief Replace the lead times of deadline reminders (e.g. 24h, 1h, 10m)
+     *
+     * Triggers on `tasks` turn every write of an active Deadline task into one
+     * `scheduled_events` row per lead still in the future, so fire times are computed
+     * once, when the deadline is written. Changing the leads rebuilds the pending events;
+     * calling it with the current leads costs one SELECT.
+     */
+    void setDeadlineLeads(std::span<const std::chrono::seconds> leads);
+    std::vector<std::chrono::seconds> deadlineLeads() const;
+
+    /**
+     * @brief Take up to `limit` deadline events due at or before `now`, earliest first, deleting them
+     */
+    std::vector<DeadlineEvent> claimDueEvents(PeriodicTracker::TimePoint now, std::size_t limit);
+
+    /**
+     * @brief Fire time of the earliest pending deadline event (uses the fire_at index)
+     */
+    std::optional<PeriodicTracker::TimePoint> nextEventTime() const;
+
+    /**
+     * @brief Mark a task completed and executed at `when` with one UPDATE by primary key
+     *
+     * A recurring task is never finished: it stays active, `when` becomes its last execution
+     * and its next one is a period later.
+     * @param owner If set, only a task created by this chat or in the GUI is completed
+     *              (GUI tasks have no owner and are reminded to every chat)
+     * @return Number of rows changed: 0 if no such task (for this owner)
+     */
+    int completeTask(std::string_view id, PeriodicTracker::TimePoint when, OwnerFilter owner = std::nullopt);
+
+    /**
+     * @brief Load one task
+     * @param owner When set, only a task owned by this chat or by no chat (created in the GUI) is found
+     * @throws std::runtime_error If there is no such task
+     */
+    Task getTaskById(const std::string& id, OwnerFilter owner = std::nullopt);
+
+    /**
+     * @brief Insert many tasks in one BEGIN IMMEDIATE ... COMMIT transaction with a single reused statement
+     * @throws std::runtime_error In AllOrNothing mode if any row fails (nothing is written)
+     */
+    BatchResult saveTasks(std::span<const Task> tasks, BatchMode mode = BatchMode::AllOrNothing, const std::string& table_name = "tasks");
+
+    /**
+     * @brief Update many tasks in one transaction (see saveTasks)
+     */
+    BatchResult updateTasks(std::span<const Task> tasks, BatchMode mode = BatchMode::AllOrNothing, const std::string& table_name = "tasks");
+
+    /**
+     * @brief Delete many tasks by id in one transaction (see saveTasks)
+     */
+    BatchResult deleteTasks(std::span<const std::string> ids, BatchMode mode = BatchMode::AllOrNothing, const std::string& table_name = "tasks");
+
     std::vector<Task> getAllTasks(const std::string& table_name = "tasks");
 
+    /**
+     * @brief Stream tasks row by row without materializing them
+     * @param visitor Called once per row with a temporary Task; return false to stop
+     * @return Number of rows visited
+     */
+    std::size_t forEachTask(const TaskVisitor& visitor, const std::string& table_name = "tasks");
+
+    /**
+     * @brief Tasks created by one chat (uses the (owner_chat_id, status) index)
+     */
+    std::vector<Task> getTasksByOwner(std::string_view owner_chat_id);
+
+    /**
+     * @brief Streaming form of getTasksByOwner (see forEachTask)
+     */
+    std::size_t forEachTaskOfOwner(std::string_view owner_chat_id, const TaskVisitor& visitor);
+
+    /**
+     * @brief Active tasks whose deadline or next execution is at or before `time` (uses the deadline/next_execution indexes)
+     */
+    std::vector<Task> getTasksDueBefore(PeriodicTracker::TimePoint time, OwnerFilter owner = std::nullopt);
+
+    /**
+     * @brief Streaming form of getTasksDueBefore (see forEachTask)
+     */
+    std::size_t forEachTaskDueBefore(PeriodicTracker::TimePoint time, const TaskVisitor& visitor, OwnerFilter owner = std::nullopt);
+
+    /**
+     * @brief Take up to `limit` active tasks whose next execution is at or before `now`, earliest first,
+     *        and record their execution at `now` in the same transaction
+     *
+     * Reads only due rows through the (status, next_execution) index; the written rows get their
+     * next execution, so a task is claimed once per period even if callers overlap.
+     * @return The claimed tasks, already marked executed
+     */
+    std::vector<Task> claimDueTasks(PeriodicTracker::TimePoint now, std::size_t limit);
+
+    /**
+     * @brief Active tasks whose next execution is at or before `now`, earliest first, left unclaimed
+     *
+     * With claimTask() the caller claims a task only once its reminder went out, so a failed
+     * send or a crash in between leaves the task due.
+     */
+    std::vector<Task> getDueTasks(PeriodicTracker::TimePoint now, std::size_t limit);
+
+    /**
+     * @brief Record the execution of one task at `now` if it is still due then (see claimDueTasks)
+     * @return The claimed task, or nothing if it is no longer due or gone
+     */
+    std::optional<Task> claimTask(std::string_view id, PeriodicTracker::TimePoint now);
+
+    /**
+     * @brief The last `limit` executions of a task, oldest first
+     *
+     * Every new value the write methods of this class put into `tasks.last_execution` is appended to the
+     * task's row in `execution_history`, in the same transaction: one delta-encoded blob per task
+     * (see ExecutionHistory) instead of a row per execution. Tasks with executions recorded before
+     * schema version 7 start from their last one.
+     */
+    std::vector<PeriodicTracker::TimePoint> recentExecutions(std::string_view task_id, std::size_t limit) const;
+
+    /**
+     * @brief Number of executions stored for a task (0 if none)
+     */
+    std::size_t executionCount(std::string_view task_id) const;
+
+    /**
+     * @brief Tasks with the given status (uses the (status, type) index, or the owner index when scoped)
+     */
+    std::vector<Task> getTasksByStatus(Task::Status status, OwnerFilter owner = std::nullopt);
+
+    /**
+     * @brief Up to `limit` active tasks with the nearest deadline or next execution not earlier than `from`, soonest first
+     */
+    std::vector<Task> getUpcoming(std::size_t limit, PeriodicTracker::TimePoint from = PeriodicTracker::Clock::now(),
+                                  OwnerFilter owner = std::nullopt);
+
+    /**
+     * @brief Subscribe to committed task writes
+     * @return Handle for removeTaskObserver()
+     */
+    std::size_t addTaskObserver(TaskObserver observer);
+    void removeTaskObserver(std::size_t handle);
+
     void saveTemplate(const TaskTemplate& tmpl);
     void deleteTemplate(const std::string& id);
     std::vector<TaskTemplate> getAllTemplates();
-    std::pair<int, int> getTaskStats();
+
+    /**
+     * @brief (completed, pending) task counts, read from the in-memory counters without querying SQLite
+     */
+    std::pair<int, int> getTaskStats() const noexcept;
+
+    /**
+     * @brief Counters of the `tasks` table by status and type, maintained by every task write
+     */
+    const TaskStatistics& statistics() const noexcept;
+
+    /**
+     * @brief Reload the counters with one GROUP BY query (e.g. after the file was changed by another process)
+     */
+    void refreshStatistics();
+
     void saveChatId(const std::string& chat_id);
+
+    /**
+     * @brief Registered chats in registration order, copied from memory (see ChatRegistry)
+     */
     std::vector<std::string> getAllChatIds() const;
+
+    /**
+     * @brief Whether a chat ran /start; one hash lookup, no SQLite call and no allocation
+     */
+    bool isChatRegistered(std::string_view chat_id) const;
     void unlinkAllAccounts();
     void deleteAllChatIds();
-    void addColumnIfNotExists(const std::string& table, const std::string& column, const std::string& type);
     bool tableExists(const std::string& tableName);
     std::string getFirstChatId() const;
+
+    /**
+     * @brief Whether the database runs in WAL mode
+     */
+    bool isWalEnabled() const noexcept;
+
+    /**
+     * @brief Number of read-only connections serving reads (0 when reads share the writer)
+     */
+    std::size_t readPoolSize() const noexcept;
 private:
-    sqlite3* db_;  ///< SQLite database connection handle
+    ///< Query shapes kept prepared in the statement cache
+    enum class Query {
+        InsertTask,
+        UpdateTask,
+        DeleteTask,
+        SelectTaskById,
+        SelectAllTasks,
+        InsertLog,
+        InsertTemplate,
+        SelectTemplates,
+        InsertChatId,
+        SelectChatIds,
+        CountByStatusType,
+        SelectStatusType,
+        TableExists,
+        SelectDueBefore,
+        SelectByStatus,
+        SelectUpcoming,
+        SelectByOwner,
+        SelectTaskByIdForOwner,
+        SelectDueBeforeForOwner,
+        SelectByStatusForOwner,
+        SelectUpcomingForOwner,
+        CompleteTask,
+        CompleteTaskForOwner,
+        SelectDueExecutions,
+        PurgeCompleted,
+        SelectLeads,
+        InsertLead,
+        SelectDueEvents,
+        DeleteDueEvents,
+        NextEventTime,
+        SelectHistory,
+        CountHistory,
+        SelectHistoryLast,
+        AppendHistory,
+        SetNextExecution,
+        SelectDueById
+    };
+
+    sqlite3* db_;  ///< SQLite database connection handle (the only writer)
+    std::unique_ptr<StatementCache> statements_;  ///< Prepared statements of db_, finalized before close
+    std::unique_ptr<ReadConnectionPool> readers_;  ///< Read-only connections in WAL mode, otherwise null
+    bool wal_enabled_ = false;
+    std::unique_ptr<AuditLogWriter> log_writer_;  ///< Background writer of `logs`, null when async_log is off
+    TaskStatistics stats_;  ///< Counters of the `tasks` table
+    ChatRegistry chats_;    ///< Contents of `telegram_chats`, written through by every chat write
+    mutable std::mutex observers_mutex_;
+    std::vector<std::pair<std::size_t, TaskObserver>> observers_;
+    std::size_t next_observer_ = 0;
 
+    void configureConnection(const std::string& db_path, const DatabaseOptions& options);
     void executeQuery(const std::string& sql, const std::vector<std::string>& params = {});
-    void throwOnError(int rc, const std::string& context) const;
-    void executeTaskQuery(const std::string& sql, const Task& task);
+    void throwOnError(int rc, const std::string& context, sqlite3* db = nullptr) const;
+    void executeTaskStatement(sqlite3_stmt* stmt, const Task& task);
+    void writeLogBatch(std::span<const LogEntry> entries);
+
+    /**
+     * @brief Fill chats_ from `telegram_chats` (once, when the database opens)
+     */
+    void loadChatIds();
+    void notifyTaskObservers(TaskChange change, std::string_view id, const Task* task);
+
+    /**
+     * @brief Run one cached statement for `count` rows inside a single transaction
+     * @param bind Binds the parameters of row i
+     * @param written Called after row i was written, before the commit (optional)
+     */
+    BatchResult executeBatch(CachedStatement& stmt, std::size_t count, BatchMode mode,
+                             const std::function<void(sqlite3_stmt*, std::size_t)>& bind, const char* context,
+                             const std::function<void(std::size_t)>& written = nullptr);
+
+    /**
+     * @brief Append an execution to the task's `execution_history` row unless it is already the last one
+     * @note Call inside the transaction that wrote `tasks.last_execution`
+     */
+    void appendExecution(std::string_view task_id, PeriodicTracker::TimePoint when);
+
+    /**
+     * @brief recentExecutions on the writer, for use inside its transactions
+     */
+    std::vector<PeriodicTracker::TimePoint> storedExecutions(std::string_view task_id, std::size_t limit);
+
+    /**
+     * @brief Decode the history row selected by `stmt` (task id bound as parameter 1)
+     */
+    std::vector<PeriodicTracker::TimePoint> decodeExecutions(CachedStatement& stmt, std::string_view task_id, std::size_t limit) const;
+
+    /**
+     * @brief Advance the tasks just selected as due (see advanceSchedule) and write them back
+     */
+    void claimSelected(std::vector<Task>& tasks, PeriodicTracker::TimePoint now);
+
+    /**
+     * @brief Mark a recurring task executed at `when` and set its next execution after `when`
+     *
+     * The tracker is refilled from the stored history first. Once it holds more than
+     * PeriodicTracker::kHistory executions, the next run follows the learned interval
+     * (kept within half and twice the configured one).
+     * @param due The run being served; without one the next run is a period after `when`.
+     *            Periods already missed are skipped.
+     */
+    void advanceSchedule(Task& task, PeriodicTracker::TimePoint when, std::optional<PeriodicTracker::TimePoint> due);
+
+    /**
+     * @brief Status and type currently stored for a task, if the row exists (runs on the writer)
+     */
+    std::optional<std::pair<Task::Status, Task::Type>> storedStatusType(std::string_view id);
+
+    /**
+     * @brief Get a cached statement whose SQL is sql_prefix + table_name + sql_suffix
+     */
+    CachedStatement cachedStatement(Query query, const std::string& table_name, const char* sql_prefix, const char* sql_suffix) const;
+
+    /**
+     * @brief Get a cached statement for SQL that does not depend on a table name
+     */
+    CachedStatement cachedStatement(Query query, const char* sql) const;
+
+    /**
+     * @brief Like cachedStatement(), but served by the read pool when one is open
+     */
+    CachedStatement readStatement(Query query, const std::string& table_name, const char* sql_prefix, const char* sql_suffix) const;
+    CachedStatement readStatement(Query query, const char* sql) const;
     
     void bindTaskParameters(sqlite3_stmt* stmt, const Task& task);
-    Task mapTaskFromRow(sqlite3_stmt* stmt);
+    void mapTaskFromRow(sqlite3_stmt* stmt, Task& task);
+    std::size_t visitTasks(sqlite3_stmt* stmt, const TaskVisitor& visitor, const char* context);
+    std::vector<Task> collectTasks(sqlite3_stmt* stmt, const char* context);
+};
+
+/**
+ * @brief Task observer registration that is removed when the object is destroyed or reset
+ */
+class ScopedTaskObserver {
+public:
+    ScopedTaskObserver() = default;
+    ScopedTaskObserver(DatabaseManager& db, DatabaseManager::TaskObserver observer);
+    ~ScopedTaskObserver();
+
+    ScopedTaskObserver(const ScopedTaskObserver&) = delete;
+    ScopedTaskObserver& operator=(const ScopedTaskObserver&) = delete;
+
+    ScopedTaskObserver(ScopedTaskObserver&& other) noexcept;
+    ScopedTaskObserver& operator=(ScopedTaskObserver&& other) noexcept;
+
+    /**
+     * @brief Remove the observer now; no notification starts after this returns
+     */
+    void reset() noexcept;
+
+private:
+    DatabaseManager* db_ = nullptr;
+    std::size_t handle_ = 0;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef EXECUTION_HISTORY_HPP
+#define EXECUTION_HISTORY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @class ExecutionHistory
+ * @brief Byte format of the `execution_history.deltas` column
+ *
+ * A task's executions are stored as one blob of varints, one per execution: the difference
+ * to the previous execution in seconds (to 0 for the first one), zigzag-encoded so that
+ * out-of-order timestamps stay short. A daily task costs 3 bytes per execution, and a new
+ * execution is appended without decoding what is already stored.
+ */
+class ExecutionHistory {
+public:
+    using Blob = std::vector<std::uint8_t>;
+
+    /**
+     * @brief Append `timestamp` to a blob whose last execution is `previous` (0 for an empty blob)
+     */
+    static void append(Blob& blob, std::int64_t previous, std::int64_t timestamp);
+
+    /**
+     * @brief The last `limit` executions, oldest first, in seconds since the epoch
+     * @throws std::runtime_error If the blob ends in the middle of a varint
+     */
+    static std::vector<std::int64_t> decodeLast(std::span<const std::uint8_t> blob, std::size_t limit);
+
+    /**
+     * @brief Number of executions in a blob (one per byte without the continuation bit)
+     */
+    static std::size_t count(std::span<const std::uint8_t> blob) noexcept;
+};
+
+#endif
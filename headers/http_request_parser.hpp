@@ -0,0 +1,76 @@
+#ifndef HTTP_REQUEST_PARSER_HPP
+#define HTTP_REQUEST_PARSER_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief One parsed HTTP/1.x request
+ */
+struct HttpRequest {
+    std::string method;
+    std::string target;  ///< Path with the query string, as sent
+    std::unordered_map<std::string, std::string> headers;  ///< Names in lower case
+    std::string body;
+    bool keep_alive = true;
+
+    /**
+     * @brief Header value by lower-case name, empty if absent
+     */
+    std::string header(const std::string& name) const;
+};
+
+/**
+ * @class HttpRequestParser
+ * @brief Incremental parser for the HTTP/1.1 requests a webhook receives
+ *
+ * Bytes are fed as they arrive; a request may span several reads and one read may
+ * hold several pipelined requests. Only Content-Length bodies are accepted
+ * (Telegram does not use chunked uploads). Header and body sizes are capped.
+ */
+class HttpRequestParser {
+public:
+    enum class Result {
+        NeedMore,  ///< The buffered bytes do not hold a full request yet
+        Complete,  ///< A request is ready, see take()
+        Error,     ///< Malformed or oversized; the connection should be closed
+    };
+
+    explicit HttpRequestParser(std::size_t max_body = 1 << 20, std::size_t max_header = 16 << 10);
+
+    /**
+     * @brief Append bytes and try to complete a request; feed({}) re-checks buffered bytes
+     */
+    Result feed(std::string_view data);
+
+    /**
+     * @brief Move out the completed request; the parser continues with the bytes after it
+     */
+    HttpRequest take();
+
+    const std::string& error() const noexcept;
+
+private:
+    Result parse();
+
+    /**
+     * @brief Parse the request line and headers into request_; Complete once the head is done
+     */
+    Result parseHead();
+    Result fail(std::string message);
+
+    std::size_t max_body_;
+    std::size_t max_header_;
+    std::string buffer_;
+    HttpRequest request_;
+    bool complete_ = false;
+    bool head_parsed_ = false;    ///< request_ holds the head, the body is still arriving
+    std::size_t scanned_ = 0;     ///< Bytes already searched for the end of the head
+    std::size_t body_start_ = 0;  ///< Offset of the body in buffer_, once the head is parsed
+    std::size_t body_length_ = 0;
+    std::string error_;
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef MESSAGE_SENDER_HPP
+#define MESSAGE_SENDER_HPP
+
+#include "curl_handle.hpp"
+#include <curl/curl.h>
+#include <array>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Settings of the outbound Bot API client
+ */
+struct MessageSenderOptions {
+    std::string api_base_url = "https://api.telegram.org";  ///< Scheme and host of the Bot API (no trailing slash)
+    std::size_t max_handles = 4;        ///< Easy handles kept alive; callers wait when all are busy
+    bool http2 = true;                  ///< Negotiate HTTP/2 over TLS when the server supports it
+    long timeout_ms = 10000;            ///< Whole-request timeout
+    long connect_timeout_ms = 5000;
+};
+
+/**
+ * @brief Outcome of one Bot API call
+ */
+struct SendResult {
+    CURLcode curl_code = CURLE_OK;
+    long http_status = 0;
+    std::string body;       ///< Raw JSON response (e.g. for `retry_after` on 429)
+
+    bool ok() const noexcept { return curl_code == CURLE_OK && http_status == 200; }
+};
+
+/**
+ * @class MessageSender
+ * @brief Long-lived sendMessage client that keeps connections to the Bot API open
+ *
+ * Easy handles are pooled and reused, each keeping its own keep-alive connection, and all
+ * of them share one CURLSH with the DNS cache and TLS sessions, so a send normally skips the
+ * DNS lookup, TCP connect and TLS handshake. The connection cache is not shared: libcurl
+ * does not support that across threads. Thread-safe.
+ */
+class MessageSender {
+public:
+    /**
+     * @throws std::invalid_argument If the token is empty
+     * @throws std::runtime_error If the share handle cannot be created
+     */
+    explicit MessageSender(std::string bot_token, MessageSenderOptions options = MessageSenderOptions());
+    ~MessageSender();
+
+    MessageSender(const MessageSender&) = delete;
+    MessageSender& operator=(const MessageSender&) = delete;
+
+    /**
+     * @brief POST sendMessage and wait for the response
+     */
+    SendResult send(const std::string& chat_id, const std::string& text);
+
+    /**
+     * @brief Full URL of a Bot API method, e.g. method_url("sendMessage")
+     */
+    std::string method_url(const std::string& method) const;
+
+    /**
+     * @brief Apply the shared connection settings (share handle, HTTP version, keep-alive) to any easy handle
+     *
+     * Lets other clients of the same bot, such as the async engine, reuse the DNS cache and TLS sessions.
+     */
+    void configure(CURL* handle) const;
+
+    /**
+     * @brief Form-encode the sendMessage parameters
+     */
+    static std::string encode_message(CURL* handle, const std::string& chat_id, const std::string& text);
+
+    const MessageSenderOptions& options() const noexcept;
+
+private:
+    CurlHandle acquire();
+    void release(CurlHandle handle) noexcept;
+
+    static void lock_share(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void unlock_share(CURL* handle, curl_lock_data data, void* userptr);
+    static size_t write_body(char* data, size_t size, size_t nmemb, void* userp);
+
+    std::string bot_token_;
+    MessageSenderOptions options_;
+    std::string send_url_;
+
+    CURLSH* share_ = nullptr;
+    std::array<std::mutex, CURL_LOCK_DATA_LAST> share_locks_;
+
+    std::mutex pool_mutex_;
+    std::condition_variable pool_cv_;
+    std::vector<CurlHandle> idle_;
+    std::size_t created_ = 0;
+};
+
+#endif
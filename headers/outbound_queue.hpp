@@ -0,0 +1,139 @@
+#ifndef OUTBOUND_QUEUE_HPP
+#define OUTBOUND_QUEUE_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Token bucket: `rate` tokens per second, at most `capacity` stored
+ */
+class TokenBucket {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    TokenBucket(double rate, double capacity, Clock::time_point now) noexcept;
+
+    /**
+     * @brief Take one token if available
+     */
+    bool try_take(Clock::time_point now) noexcept;
+
+    /**
+     * @brief Earliest moment a token is available (`now` if one is available already)
+     */
+    Clock::time_point ready_at(Clock::time_point now) noexcept;
+
+    /**
+     * @brief Whether the bucket holds `capacity` tokens again, i.e. is as good as a new one
+     */
+    bool full(Clock::time_point now) noexcept;
+
+private:
+    void refill(Clock::time_point now) noexcept;
+
+    double rate_;
+    double capacity_;
+    double tokens_;
+    Clock::time_point updated_;
+};
+
+/**
+ * @brief Limits of the outbound queue, defaults follow the Bot API FAQ
+ */
+struct OutboundLimits {
+    double global_per_second = 30.0;   ///< All chats together
+    double global_burst = 1.0;         ///< Tokens stored globally; 1 spaces sends evenly
+    double chat_per_second = 1.0;      ///< One private chat
+    double group_per_second = 20.0 / 60.0;  ///< One group (negative chat id)
+};
+
+/**
+ * @class OutboundQueue
+ * @brief Orders outgoing messages by priority and releases them no faster than Telegram allows
+ *
+ * A global bucket caps the total rate and every chat has its own bucket. Each priority lane
+ * visits its chats round-robin, so one busy chat cannot hold back the others, and a lane is
+ * only served when no higher lane has a sendable message. Messages of one chat and lane keep
+ * their order. After a 429 the chat is paused for `retry_after` and the message goes back to
+ * the front of its lane. A chat with nothing queued is forgotten once its bucket is full and
+ * its pause is over, so the per-chat state does not grow with every chat ever messaged.
+ *
+ * Pure scheduling logic driven by explicit time points; not thread-safe.
+ */
+class OutboundQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Priority {
+        Reminder,       ///< Due reminders
+        Housekeeping,   ///< Notices such as removed tasks
+    };
+    static constexpr std::size_t kLanes = 2;
+
+    struct Message {
+        std::string chat_id;
+        std::string text;
+        Priority priority = Priority::Reminder;
+        std::function<void(bool)> sent;  ///< For the sender: call once with the outcome (not on a 429 retry)
+    };
+
+    explicit OutboundQueue(OutboundLimits limits = {}, Clock::time_point now = Clock::now());
+
+    void push(std::string chat_id, std::string text, Priority priority, Clock::time_point now = Clock::now());
+    void push(Message message, Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Next message that may be sent at `now`, or nothing if every candidate is throttled
+     */
+    std::optional<Message> pop(Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Earliest moment pop() can return a message; nothing if the queue is empty
+     */
+    std::optional<Clock::time_point> next_ready(Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Handle HTTP 429: pause the chat for `retry_after` and queue the message again in front
+     */
+    void retry_after(Message message, std::chrono::seconds retry_after, Clock::time_point now = Clock::now());
+
+    std::size_t size() const noexcept;
+    bool empty() const noexcept;
+
+    /**
+     * @brief Number of chats whose state is kept (queued messages, a refilling bucket or a pause)
+     */
+    std::size_t chat_count() const noexcept;
+
+private:
+    struct Chat {
+        TokenBucket bucket;
+        Clock::time_point paused_until{};
+        std::array<std::deque<Message>, kLanes> lanes;
+        std::size_t queued = 0;
+    };
+
+    Chat& chat(const std::string& chat_id, Clock::time_point now);
+    Clock::time_point chatReadyAt(Chat& chat, Clock::time_point now);
+    void enqueue(Message message, bool front, Clock::time_point now);
+
+    /**
+     * @brief Drop the idle chats that a new entry would replace unchanged
+     */
+    void evictIdle(Clock::time_point now);
+
+    OutboundLimits limits_;
+    TokenBucket global_;
+    std::unordered_map<std::string, Chat> chats_;
+    std::array<std::deque<std::string>, kLanes> rotation_;  ///< Chats with messages in each lane, in visiting order
+    std::deque<std::string> idle_;  ///< Chats in the order they ran out of messages; may hold stale ids
+    std::size_t size_ = 0;
+};
+
+#endif
@@ -1,35 +1,60 @@
 #ifndef PERIODIC_TRACKER_HPP
 #define PERIODIC_TRACKER_HPP
 
+#include <array>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <stdexcept>
 #include <optional>
+#include <vector>
 
 /**
  * @class PeriodicTracker
- * @brief Records the first and second execution timestamps of a task, computes the interval between them, and predicts future execution dates
+ * @brief Records the executions of a task and predicts the next one from the observed cadence
+ *
+ * Any number of executions can be recorded. The last kHistory timestamps are kept in a
+ * ring buffer; the intervals between executions feed running statistics updated in O(1):
+ * an exponentially weighted mean and variance (weight kSmoothing for the newest interval)
+ * and the minimum and maximum. The whole tracker stays within 64 bytes, as one lives in
+ * every resident recurring task.
  */
 class PeriodicTracker {
 public:
     using Clock = std::chrono::system_clock;
     using TimePoint = Clock::time_point;
 
+    static constexpr std::size_t kHistory = 4;   ///< Executions kept for recent_executions()
+    static constexpr double kSmoothing = 0.25;   ///< EWMA weight of the newest interval
+
     /**
      * @brief Record a task execution event 
      * @param timestamp The time when the task was executed
-     * @throws std::logic_error if called more than twice
      */
     void mark_execution(const TimePoint& timestamp);
 
     /**
-     * @brief Calculate the interval between the first and second executions
+     * @brief Smoothed (EWMA) interval between executions; equals the only interval after two executions
      * @return Interval (in seconds)
      * @throws std::logic_error if less than two executions are recorded 
      */
     std::chrono::seconds get_interval() const;
 
     /**
-     * @brief Get the next execution time (based on the calculated interval)
+     * @brief Exponentially weighted variance of the intervals, in seconds squared (0 after two executions)
+     * @throws std::logic_error if less than two executions are recorded
+     */
+    double get_interval_variance() const;
+
+    /**
+     * @brief Shortest and longest interval observed
+     * @throws std::logic_error if less than two executions are recorded
+     */
+    std::chrono::seconds get_min_interval() const;
+    std::chrono::seconds get_max_interval() const;
+
+    /**
+     * @brief Get the next execution time: the last execution plus the smoothed interval
      * @return Time Point of the next execution or std::nullopt if interval is not set
      */
     std::optional<TimePoint> get_next_execution_time() const;
@@ -39,14 +64,24 @@ public:
      */
     bool is_interval_set() const noexcept;
 
-    const std::optional<TimePoint>& get_first_execution() const noexcept;
-    const std::optional<TimePoint>& get_second_execution() const noexcept;
+    /**
+     * @brief Number of executions recorded since construction
+     */
+    std::uint32_t execution_count() const noexcept;
+
+    /**
+     * @brief Up to kHistory latest executions, oldest first
+     */
+    std::vector<TimePoint> recent_executions() const;
     std::optional<TimePoint> get_last_execution() const noexcept;
 
 private:
-    std::optional<TimePoint> first_execution_;
-    std::optional<TimePoint> second_execution_;
-    std::optional<std::chrono::seconds> interval_;
+    std::array<TimePoint, kHistory> recent_{};   ///< Ring buffer, slot count_ % kHistory is written next
+    double mean_interval_ = 0.0;                 ///< EWMA of the intervals, seconds
+    double variance_ = 0.0;                      ///< EW variance of the intervals, seconds squared
+    std::int32_t min_interval_ = 0;              ///< Seconds
+    std::int32_t max_interval_ = 0;              ///< Seconds
+    std::uint32_t count_ = 0;
 };
 
-#endif
\ No newline at end of file
+#endif
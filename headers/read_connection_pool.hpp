@@ -0,0 +1,53 @@
+#ifndef READ_CONNECTION_POOL_HPP
+#define READ_CONNECTION_POOL_HPP
+
+#include "statement_cache.hpp"
+#include <sqlite3.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @class ReadConnectionPool
+ * @brief Small pool of read-only SQLite connections for a database in WAL mode
+ *
+ * Readers never wait for the writer connection: in WAL mode each read runs on its own
+ * snapshot. Every connection keeps its own StatementCache; a lease on a statement also
+ * leases the connection it belongs to.
+ */
+class ReadConnectionPool {
+public:
+    /**
+     * @brief Open `size` read-only connections to an existing database
+     * @param db_path Path to the database file (must already be in WAL mode)
+     * @param size Number of connections (> 0)
+     * @param busy_timeout_ms Busy handler timeout for each connection
+     * @throws std::runtime_error If a connection cannot be opened
+     */
+    ReadConnectionPool(const std::string& db_path, std::size_t size, int busy_timeout_ms);
+    ~ReadConnectionPool();
+
+    ReadConnectionPool(const ReadConnectionPool&) = delete;
+    ReadConnectionPool& operator=(const ReadConnectionPool&) = delete;
+
+    /**
+     * @brief Get a cached statement on a free connection, waiting for one if all are busy
+     */
+    CachedStatement acquire(int query_id, const std::string& table, const StatementCache::SqlBuilder& build_sql);
+
+    std::size_t size() const noexcept;
+
+private:
+    struct Connection {
+        sqlite3* db = nullptr;
+        std::unique_ptr<StatementCache> statements;
+    };
+
+    void close() noexcept;
+
+    std::vector<Connection> connections_;
+    std::atomic<std::size_t> next_{0};  ///< Round-robin start for the free-connection search
+};
+
+#endif
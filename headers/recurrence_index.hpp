@@ -0,0 +1,92 @@
+#ifndef RECURRENCE_INDEX_HPP
+#define RECURRENCE_INDEX_HPP
+
+#include "periodic_tracker.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Task;
+
+/**
+ * @class RecurrenceIndex
+ * @brief Recurring tasks as parallel arrays, for finding the due ones without touching Task objects
+ *
+ * Entry i is (last_execution[i], interval[i], end_date[i]) in seconds since the epoch; its next
+ * fire time is last_execution + interval, unless that is past the end date or the interval is not
+ * positive (then it never fires). evaluate() computes every next fire time and a due bitmask in one
+ * pass over 24 bytes per task, with AVX2 or SSE4.2 kernels chosen at runtime and a scalar fallback.
+ */
+class RecurrenceIndex {
+public:
+    ///< Kernel used by evaluate(); Best picks the widest one the CPU supports
+    enum class Kernel {
+        Best,
+        Scalar,
+        Sse42,
+        Avx2
+    };
+
+    static constexpr std::int64_t kNever = std::numeric_limits<std::int64_t>::max();  ///< Next fire time of entries that never fire
+    static constexpr std::int64_t kNoEndDate = std::numeric_limits<std::int64_t>::max();
+
+    /**
+     * @brief Add a task as it would be scheduled at `now` (see Task::next_execution_time)
+     * @return false, and nothing is added, if the task has no next execution
+     */
+    bool add(const Task& task, PeriodicTracker::TimePoint now);
+
+    /**
+     * @brief Add an entry directly
+     * @return Its position
+     */
+    std::size_t add(std::string_view id, std::int64_t last_execution, std::int64_t interval,
+                    std::int64_t end_date = kNoEndDate);
+
+    /**
+     * @brief Record an execution of entry i: its next fire time moves to `timestamp` + interval
+     */
+    void mark_execution(std::size_t i, std::int64_t timestamp) noexcept;
+
+    /**
+     * @brief Compute next fire times and the due bitmask for all entries
+     * @param next Receives size() fire times (kNever for entries that never fire)
+     * @param due Receives (size() + 63) / 64 words; bit i % 64 of word i / 64 is set if entry i fires at or before `now`
+     * @throws std::invalid_argument If an output span is too small or the kernel is not supported by the CPU
+     * @return Number of due entries
+     */
+    std::size_t evaluate(std::int64_t now, std::span<std::int64_t> next, std::span<std::uint64_t> due,
+                         Kernel kernel = Kernel::Best) const;
+
+    /**
+     * @brief Positions of the entries due at or before `now`, ascending
+     */
+    std::vector<std::size_t> due(std::int64_t now) const;
+
+    /**
+     * @brief Whether this CPU can run `kernel` (Scalar and Best always can)
+     */
+    static bool supports(Kernel kernel) noexcept;
+
+    /**
+     * @brief The kernel Best resolves to on this CPU
+     */
+    static Kernel best_kernel() noexcept;
+
+    const std::string& id(std::size_t i) const;
+    std::size_t size() const noexcept;
+    void reserve(std::size_t count);
+    void clear() noexcept;
+
+private:
+    std::vector<std::int64_t> last_execution_;
+    std::vector<std::int64_t> interval_;
+    std::vector<std::int64_t> end_date_;
+    std::vector<std::string> ids_;  ///< Cold: only read for the due entries
+};
+
+#endif
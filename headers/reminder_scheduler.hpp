@@ -0,0 +1,94 @@
+#ifndef REMINDER_SCHEDULER_HPP
+#define REMINDER_SCHEDULER_HPP
+
+#include "task.hpp"
+#include "periodic_tracker.hpp"
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class ReminderScheduler
+ * @brief Min-heap of the moments tasks need the bot's attention
+ *
+ * Built once from the database and kept current from write notifications, so the bot
+ * can sleep exactly until next_due() instead of sweeping every task on a fixed period.
+ * Rescheduling or cancelling a task is O(log n): the old heap entry is left behind and
+ * skipped when it surfaces (it no longer matches the task's current generation); the
+ * heap is compacted when stale entries outnumber live ones.
+ *
+ * Not thread-safe: owned and used by the bot's thread.
+ */
+class ReminderScheduler {
+public:
+    using Clock = PeriodicTracker::Clock;
+    using TimePoint = PeriodicTracker::TimePoint;
+
+    /**
+     * @brief Add a task or move it to a new time
+     */
+    void schedule(std::string_view task_id, TimePoint when);
+
+    /**
+     * @brief Remove a task; false if it was not scheduled
+     */
+    bool cancel(std::string_view task_id);
+
+    void clear() noexcept;
+
+    /**
+     * @brief Earliest scheduled time, nothing if the schedule is empty
+     */
+    std::optional<TimePoint> next_due();
+
+    /**
+     * @brief Remove and return the tasks due at or before `now`, earliest first
+     */
+    std::vector<std::string> pop_due(TimePoint now);
+
+    std::size_t size() const noexcept;
+    bool contains(std::string_view task_id) const;
+
+    /**
+     * @brief When the bot should next look at a task, nothing if it needs no attention
+     *
+     * Active recurring tasks fire at Task::next_execution_time(), the value stored in
+     * `next_execution`. Completed one-time tasks are due at once, to be announced and removed.
+     */
+    static std::optional<TimePoint> fire_time(const Task& task, TimePoint now);
+
+private:
+    struct Entry {
+        TimePoint when;
+        std::uint64_t generation;
+        std::string task_id;
+    };
+
+    struct Later {
+        bool operator()(const Entry& a, const Entry& b) const noexcept {
+            return a.when > b.when;
+        }
+    };
+
+    struct IdHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view id) const noexcept {
+            return std::hash<std::string_view>{}(id);
+        }
+    };
+
+    bool isLive(const Entry& entry) const;
+    void dropStale();
+    void compactIfNeeded();
+
+    std::priority_queue<Entry, std::vector<Entry>, Later> heap_;
+    std::unordered_map<std::string, std::uint64_t, IdHash, std::equal_to<>> live_;  ///< task id -> generation of its heap entry
+    std::uint64_t next_generation_ = 0;
+};
+
+#endif
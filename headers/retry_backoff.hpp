@@ -0,0 +1,41 @@
+#ifndef RETRY_BACKOFF_HPP
+#define RETRY_BACKOFF_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+
+/**
+ * @class RetryBackoff
+ * @brief Exponential backoff with jitter for retrying failed network calls
+ *
+ * The n-th consecutive failure waits a random time in [d/2, d], where
+ * d = min(initial * 2^n, max). The random half keeps clients that failed together
+ * from retrying in lockstep. reset() after a success starts again from `initial`.
+ */
+class RetryBackoff {
+public:
+    /**
+     * @throws std::invalid_argument If `initial` is not positive or `max` is below `initial`
+     */
+    explicit RetryBackoff(std::chrono::milliseconds initial = std::chrono::milliseconds(500),
+                          std::chrono::milliseconds max = std::chrono::seconds(60),
+                          std::uint32_t seed = std::random_device{}());
+
+    /**
+     * @brief Delay before the next attempt; counts one more failure
+     */
+    std::chrono::milliseconds next();
+
+    void reset() noexcept;
+
+    int failures() const noexcept;
+
+private:
+    std::chrono::milliseconds initial_;
+    std::chrono::milliseconds max_;
+    int failures_ = 0;
+    std::mt19937 rng_;
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef SCHEMA_MIGRATOR_HPP
+#define SCHEMA_MIGRATOR_HPP
+
+#include <sqlite3.h>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class SchemaMigrator
+ * @brief Ordered schema migrations keyed on `PRAGMA user_version`
+ *
+ * Migration N brings the schema from version N-1 to N. Each one runs in its own
+ * transaction together with the user_version bump, so an upgrade either fully
+ * applies or leaves the previous version in place. A database that is already
+ * current costs a single PRAGMA read.
+ */
+class SchemaMigrator {
+public:
+    using Step = std::function<void(sqlite3*)>;
+
+    /**
+     * @param db Open connection (not owned)
+     * @param connection_mutex Lock serializing use of the connection
+     */
+    SchemaMigrator(sqlite3* db, std::recursive_mutex& connection_mutex);
+
+    /**
+     * @brief Register the migration to `version`, given as SQL (several statements allowed)
+     * @throws std::invalid_argument If versions are not registered as 1, 2, 3, ...
+     */
+    void add(int version, std::string description, std::string sql);
+
+    /**
+     * @brief Register a migration implemented in code (e.g. a data backfill)
+     */
+    void add(int version, std::string description, Step step);
+
+    /**
+     * @brief Apply every migration newer than the stored version, in order
+     * @return Number of migrations applied
+     * @throws std::runtime_error If a migration fails (it is rolled back) or the database
+     *         was created by a newer version of the application
+     */
+    int migrate();
+
+    /**
+     * @brief Version stored in the database file
+     */
+    int current_version() const;
+
+    /**
+     * @brief Version reached after all registered migrations
+     */
+    int latest_version() const noexcept;
+
+    /**
+     * @brief Run SQL on the migrated connection, throwing on error
+     */
+    static void exec(sqlite3* db, const std::string& sql);
+
+private:
+    struct Migration {
+        int version;
+        std::string description;
+        Step step;
+    };
+
+    sqlite3* db_;
+    std::recursive_mutex& mutex_;
+    std::vector<Migration> migrations_;
+};
+
+#endif
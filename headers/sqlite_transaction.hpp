@@ -0,0 +1,53 @@
+#ifndef SQLITE_TRANSACTION_HPP
+#define SQLITE_TRANSACTION_HPP
+
+#include <sqlite3.h>
+#include <mutex>
+#include <string>
+
+/**
+ * @class SqliteTransaction
+ * @brief RAII write transaction: BEGIN IMMEDIATE on construction, ROLLBACK unless commit() was called
+ *
+ * When the connection is already inside a transaction a SAVEPOINT is used instead,
+ * so guards can be nested. The connection lock is held for the whole lifetime.
+ */
+class SqliteTransaction {
+public:
+    /**
+     * @param db Open connection (not owned)
+     * @param connection_mutex Lock serializing use of the connection
+     * @throws std::runtime_error If the transaction cannot be started
+     */
+    SqliteTransaction(sqlite3* db, std::recursive_mutex& connection_mutex);
+    ~SqliteTransaction();
+
+    SqliteTransaction(const SqliteTransaction&) = delete;
+    SqliteTransaction& operator=(const SqliteTransaction&) = delete;
+
+    /**
+     * @brief Make the changes permanent (or release the savepoint)
+     * @throws std::runtime_error If COMMIT fails; the transaction is rolled back
+     */
+    void commit();
+
+    /**
+     * @brief Discard the changes made since construction
+     */
+    void rollback() noexcept;
+
+    /**
+     * @brief Whether the transaction is still open (neither committed nor rolled back)
+     */
+    bool is_active() const noexcept;
+
+private:
+    void exec(const std::string& sql);
+
+    sqlite3* db_;
+    std::unique_lock<std::recursive_mutex> lock_;
+    std::string savepoint_;  ///< Empty for a top-level transaction
+    bool active_ = false;
+};
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef STATEMENT_CACHE_HPP
+#define STATEMENT_CACHE_HPP
+
+#include <sqlite3.h>
+#include <string>
+#include <mutex>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+
+/**
+ * @class CachedStatement
+ * @brief Lease on a prepared statement owned by a StatementCache
+ *
+ * Holds the connection lock while alive. On destruction the statement is reset
+ * and its bindings are cleared, so it is ready for the next caller.
+ */
+class CachedStatement {
+public:
+    /**
+     * @param owned True for a one-off statement that must be finalized instead of returned to the cache
+     */
+    CachedStatement(sqlite3_stmt* stmt, std::unique_lock<std::recursive_mutex> lock, bool owned = false) noexcept;
+    ~CachedStatement();
+
+    CachedStatement(const CachedStatement&) = delete;
+    CachedStatement& operator=(const CachedStatement&) = delete;
+
+    CachedStatement(CachedStatement&& other) noexcept;
+    CachedStatement& operator=(CachedStatement&& other) noexcept;
+
+    operator sqlite3_stmt*() const noexcept;
+
+    /**
+     * @brief Reset the statement and clear its bindings while keeping the lease (for batch loops)
+     */
+    void reset() noexcept;
+
+private:
+    void release() noexcept;
+
+    sqlite3_stmt* stmt_;
+    std::unique_lock<std::recursive_mutex> lock_;
+    bool owned_;
+};
+
+/**
+ * @class StatementCache
+ * @brief Keeps prepared statements of one SQLite connection alive for the lifetime of that connection
+ *
+ * Statements are keyed by a caller-defined query id and the table they target,
+ * so the SQL text is built and compiled only once per (query, table) pair.
+ */
+class StatementCache {
+public:
+    using SqlBuilder = std::function<std::string()>;
+
+    /**
+     * @brief Construct a cache bound to an open connection
+     * @param db Connection the statements are prepared on (not owned)
+     */
+    explicit StatementCache(sqlite3* db);
+
+    /**
+     * @brief Finalize every cached statement
+     */
+    ~StatementCache();
+
+    StatementCache(const StatementCache&) = delete;
+    StatementCache& operator=(const StatementCache&) = delete;
+
+    /**
+     * @brief Get a ready-to-bind statement, preparing it on first use
+     * @param query_id Identifier of the query shape
+     * @param table Table the query targets (part of the cache key)
+     * @param build_sql Produces the SQL text; called only on a cache miss
+     * @throws std::runtime_error If the statement cannot be prepared
+     */
+    CachedStatement acquire(int query_id, const std::string& table, const SqlBuilder& build_sql);
+
+    /**
+     * @brief Like acquire(), but returns std::nullopt instead of waiting when another thread uses the connection
+     */
+    std::optional<CachedStatement> try_acquire(int query_id, const std::string& table, const SqlBuilder& build_sql);
+
+    /**
+     * @brief Finalize all cached statements (e.g. before a schema change or close)
+     */
+    void clear() noexcept;
+
+    std::size_t size() const noexcept;
+
+    /**
+     * @brief Lock serializing use of the underlying connection
+     */
+    std::recursive_mutex& mutex() noexcept;
+
+private:
+    struct Key {
+        int query_id;
+        std::string table;
+
+        bool operator==(const Key& other) const noexcept {
+            return query_id == other.query_id && table == other.table;
+        }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const noexcept {
+            return std::hash<std::string>{}(key.table) ^ (static_cast<std::size_t>(key.query_id) * 0x9E3779B97F4A7C15ull);
+        }
+    };
+
+    CachedStatement lease(std::unique_lock<std::recursive_mutex> lock, int query_id, const std::string& table, const SqlBuilder& build_sql);
+    sqlite3_stmt* prepare(const std::string& sql);
+
+    sqlite3* db_;
+    std::unordered_map<Key, sqlite3_stmt*, KeyHash> statements_;
+    mutable std::recursive_mutex mutex_;
+};
+
+#endif
@@ -2,7 +2,9 @@
 #define TASK_HPP
 
 #include <string>
+#include <string_view>
 #include <chrono>
+#include <optional>
 #include "periodic_tracker.hpp"
 #include <QDateTime>
 #include <QString>
@@ -60,6 +62,21 @@ public:
      */
     std::string get_description() const;
 
+    /**
+     * @brief Non-owning views of the id, title and description
+     * @note Valid until the task is modified or destroyed; used to bind columns without copying
+     */
+    std::string_view get_id_view() const noexcept;
+    std::string_view get_title_view() const noexcept;
+    std::string_view get_description_view() const noexcept;
+
+    /**
+     * @brief Telegram chat that created the task; empty for tasks created in the GUI
+     */
+    std::string get_owner_chat_id() const;
+    std::string_view get_owner_chat_id_view() const noexcept;
+    void set_owner_chat_id(const std::string& chat_id);
+
     /**
      * @brief Get the interval object
      * @return Interval in hours as std::chrono::hours 
@@ -81,6 +98,7 @@ public:
     /**
      * @brief Update task completion status
      * @param status Status true for completed, false for incomplete
+     * @note Also switches the status to Completed, or from Completed back to Active
      */
     void mark_completed(bool status);
     
@@ -97,7 +115,46 @@ public:
     QDateTime get_deadline() const noexcept;
     QDateTime get_end_date() const noexcept;
     void set_deadline(const QDateTime& deadline);
+
+    /**
+     * @brief Assign a stored deadline without validation (used when loading from the database)
+     */
+    void restore_deadline(const QDateTime& deadline) noexcept;
     void set_end_date(const QDateTime& endDate);
+
+    /**
+     * @brief Overwrite text fields in place without validation, reusing the existing string capacity
+     *
+     * Used when loading rows from the database into a reused Task.
+     */
+    void assign_id(std::string_view id) noexcept;
+    void assign_title(std::string_view title);
+    void assign_description(std::string_view description);
+    void assign_owner_chat_id(std::string_view chat_id);
+
+    /**
+     * @brief Forget recorded executions and the stored next execution (used before loading another row into the same Task)
+     */
+    void clear_executions() noexcept;
+
+    /**
+     * @brief Assign the stored next_execution (used when loading from the database and when claiming)
+     * @note mark_execution() drops it again
+     */
+    void restore_next_execution(std::optional<PeriodicTracker::TimePoint> next) noexcept;
+
+    /**
+     * @brief When an active recurring task is next due, as persisted in `next_execution`
+     *
+     * The stored value unless an execution was marked after it was assigned, else predicted
+     * from two executions, else the last execution + interval, else `now` + interval.
+     * Nothing for other tasks, a zero interval, or a time past the end date.
+     */
+    std::optional<PeriodicTracker::TimePoint> next_execution_time(PeriodicTracker::TimePoint now) const;
+
+    /**
+     * @brief Change the type; is_recurring() follows it
+     */
     void set_type(Type type);
     void set_status(Status status);
     bool is_valid() const;
@@ -107,6 +164,7 @@ private:
     char id_[19];                   ///< Unique ID (13 digits + '_' + 4 digits + '\0')
     std::string title_;             ///< Task title
     std::string description_;       ///< Task description
+    std::string owner_chat_id_;     ///< Owning Telegram chat (empty if none)
     bool is_completed_;             ///< Completion status
     std::chrono::hours interval_;   ///< Repetition interval in hours
     PeriodicTracker tracker_;
@@ -115,6 +173,7 @@ private:
     Status status_ = Active;
     QDateTime deadline_;
     QDateTime endDate_;
+    std::optional<PeriodicTracker::TimePoint> next_execution_;  ///< Stored next_execution, dropped by mark_execution()
 };
 
 #endif
\ No newline at end of file
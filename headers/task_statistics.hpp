@@ -0,0 +1,55 @@
+#ifndef TASK_STATISTICS_HPP
+#define TASK_STATISTICS_HPP
+
+#include "task.hpp"
+#include <array>
+#include <atomic>
+
+/**
+ * @class TaskStatistics
+ * @brief In-memory task counters by (status, type), kept in step with every write to the `tasks` table
+ *
+ * Loaded once from a single GROUP BY query; afterwards reading any counter is O(1)
+ * and never touches SQLite. Counters are atomic, so readers need no lock.
+ */
+class TaskStatistics {
+public:
+    static constexpr int kStatuses = Task::Status::Archived + 1;
+    static constexpr int kTypes = Task::Type::Recurring + 1;
+
+    /**
+     * @brief Pending counter changes, applied in one go once a transaction has committed
+     */
+    struct Delta {
+        std::array<int, kStatuses * kTypes> counts{};
+
+        void add(Task::Status status, Task::Type type, int n = 1) noexcept;
+        void remove(Task::Status status, Task::Type type, int n = 1) noexcept;
+    };
+
+    TaskStatistics() noexcept;
+
+    /**
+     * @brief Set every counter to zero
+     */
+    void clear() noexcept;
+
+    void set(Task::Status status, Task::Type type, int count) noexcept;
+    void add(Task::Status status, Task::Type type, int n = 1) noexcept;
+    void remove(Task::Status status, Task::Type type, int n = 1) noexcept;
+    void apply(const Delta& delta) noexcept;
+
+    int count(Task::Status status, Task::Type type) const noexcept;
+    int count(Task::Status status) const noexcept;
+    int total() const noexcept;
+
+    int completed() const noexcept;
+    int pending() const noexcept;
+
+private:
+    static int index(Task::Status status, Task::Type type) noexcept;
+
+    std::array<std::atomic<int>, kStatuses * kTypes> counts_;
+};
+
+#endif
@@ -2,11 +2,25 @@
 #define TELEGRAM_BOT_HPP
 
 #include "config_manager.hpp"
+#include "async_sender.hpp"
+#include "command_router.hpp"
+#include "curl_handle.hpp"
 #include "database_manager.hpp"
+#include "message_sender.hpp"
+#include "outbound_queue.hpp"
+#include "reminder_scheduler.hpp"
+#include "telegram_update.hpp"
+#include "webhook_server.hpp"
 #include <curl/curl.h>
+#include <functional>
+#include <future>
 #include <string>
 #include <thread>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
 #include <QObject>
 #include <QString>
@@ -19,32 +33,134 @@ public:
     TelegramBot(const ConfigManager& config, DatabaseManager& db, QObject* parent = nullptr);
     ~TelegramBot();
 
+    /**
+     * @brief Start receiving updates: the getUpdates thread, or the webhook listener
+     *        when [Telegram] Mode = webhook; no-op if already started
+     * @throws std::runtime_error If the webhook listener cannot bind its port
+     */
     void start();
+
+    /**
+     * @brief Interrupt a pending long poll or retry pause and join the getUpdates thread,
+     *        or close the webhook listener
+     */
     void stop();
 
+    /**
+     * @brief Send through the bot's persistent connection (see MessageSender)
+     */
     bool send_message(const std::string& text, const std::string& chat_id = "") const;
+
+    /**
+     * @brief Queue a message on the async engine and return at once
+     *
+     * `done` runs on this object's thread (queued through the Qt event loop), so it may
+     * touch the GUI and the database like any slot.
+     */
+    void send_message_async(const std::string& text, const std::string& chat_id, std::function<void(const SendResult&)> done);
+
+    /**
+     * @brief Queue a message on the async engine; the future is fulfilled on the engine thread
+     */
+    std::future<SendResult> send_message_async(const std::string& text, const std::string& chat_id);
+
+    /**
+     * @brief Queue a message behind Telegram's rate limits (see OutboundQueue)
+     */
+    void enqueue_message(const std::string& text, const std::string& chat_id, OutboundQueue::Priority priority);
     
+    /**
+     * @brief One-off send with a given token
+     * @note Opens its own connection each time; prefer send_message() for repeated sends
+     */
     static bool send_direct_message(const std::string& bot_token, const std::string& chat_id, const std::string& text);
 
+    /**
+     * @brief Call count and handler latency of a bot command, e.g. "/add_task"
+     */
+    std::optional<CommandMetrics> command_metrics(std::string_view command) const;
+
 signals:
     void chatIdRegistered();
 
 private:
     void pollingLoop();
+
+    /**
+     * @brief Hand a received message to processMessage on the bot's thread; used by both receive modes
+     */
+    void dispatch(IncomingMessage message);
+
+    /**
+     * @brief Run one getUpdates request; returns CURLE_ABORTED_BY_CALLBACK if stop() interrupts it
+     */
+    CURLcode performPoll(CURL* curl);
+
+    /**
+     * @brief Sleep for `delay` unless stop() is called; false if the bot is stopping
+     */
+    bool waitUnlessStopped(std::chrono::milliseconds delay);
     void processMessage(const std::string& text, const std::string& chat_id);
+
+    /**
+     * @brief Fill router_ with the bot commands and their middleware
+     */
+    void registerCommands();
+    void handleStart(const CommandContext& context);
+    void handleAddTask(const CommandContext& context);
+    void handleAddTemplate(const CommandContext& context);
+    void handleCompleteTask(const CommandContext& context);
     void check_reminders();
-    bool isUserRegistered(const std::string& chat_id) const;
 
-    static size_t dummy_write_callback(void* buffer, size_t size, size_t nmemb, void* userp);
-    static std::vector<std::string> split(const std::string& s, char delimiter);
-    static std::string trim(const std::string& s);
+    /**
+     * @brief Outcome of one reminder message; once all of a task's messages are done, claim it
+     *        if any of them went out, otherwise retry later
+     */
+    void reminderSent(const std::string& task_id, std::chrono::system_clock::time_point due_at, bool ok);
+
+    /**
+     * @brief Load the fire time of every task into scheduler_ and arm the reminder timer
+     */
+    void rebuildSchedule();
+
+    /**
+     * @brief Apply a task write to scheduler_; runs on the bot's thread
+     */
+    void reschedule(const std::string& task_id, std::optional<ReminderScheduler::TimePoint> when);
+
+    /**
+     * @brief Sleep until the earliest scheduled task (at most an hour, to follow clock changes)
+     */
+    void armReminderTimer();
+    void flush_outbound();
+    void schedule_outbound();
+    bool isUserRegistered(std::string_view chat_id) const;
+
     std::string getFirstChatId() const;
 
     std::string bot_token_;
+    std::unique_ptr<MessageSender> sender_;  ///< Keep-alive client shared by all outbound messages
+    std::unique_ptr<AsyncSender> async_sender_;  ///< Concurrent sends for reminder bursts, built on sender_
     DatabaseManager& db_;
-    bool running_;
+    std::atomic<bool> running_{false};
     std::thread polling_thread_;
-    QTimer reminderTimer;
+    CurlMultiHandle polling_multi_;  ///< Drives getUpdates so stop() can interrupt it with curl_multi_wakeup
+    std::mutex stop_mutex_;
+    std::condition_variable stop_cv_;
+    bool webhook_mode_ = false;                ///< [Telegram] Mode = webhook
+    WebhookOptions webhook_options_;
+    std::unique_ptr<WebhookServer> webhook_;   ///< Set while started in webhook mode
+    QTimer reminderTimer;     ///< Single-shot, armed for scheduler_.next_due()
+    ReminderScheduler scheduler_;  ///< Fire times of all tasks, touched on the bot's thread only
+    ScopedTaskObserver task_observer_;  ///< DatabaseManager observer feeding scheduler_
+    CommandRouter router_;    ///< Bot commands, dispatched by processMessage
+    OutboundQueue outbound_;  ///< Rate-limited messages, touched on the bot's thread only
+    struct PendingReminder {
+        std::size_t outstanding = 0;  ///< Messages not answered yet
+        bool delivered = false;       ///< At least one message went out
+    };
+    std::unordered_map<std::string, PendingReminder> pending_reminders_;  ///< Due tasks whose reminders are queued or in flight
+    QTimer outboundTimer_;    ///< Fires when the next queued message may be sent
 };
 
 #endif
\ No newline at end of file
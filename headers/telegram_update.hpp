@@ -0,0 +1,59 @@
+#ifndef TELEGRAM_UPDATE_HPP
+#define TELEGRAM_UPDATE_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Text message extracted from a Telegram Update
+ */
+struct IncomingMessage {
+    std::int64_t update_id = 0;
+    std::string chat_id;
+    std::string text;
+};
+
+/**
+ * @class TelegramUpdateParser
+ * @brief Turns Bot API Update JSON into IncomingMessage, shared by long polling and webhooks
+ *
+ * Parsing is streamed (nlohmann SAX): no JSON DOM is built, only update_id,
+ * message.chat.id and message.text are kept, and the text is moved out of the
+ * tokenizer rather than copied. Updates without a text message (edits, callbacks,
+ * joins...) are skipped but still advance the update offset.
+ *
+ * The static functions are one-off helpers; a long-lived parser object also reuses
+ * its buffers from one getUpdates response to the next.
+ */
+class TelegramUpdateParser {
+public:
+    /**
+     * @brief Parse a webhook POST body (a single Update object)
+     * @return The message, or nothing if the update carries no text message
+     * @throws std::exception If the body is not valid JSON or not an Update
+     */
+    static std::optional<IncomingMessage> parse_webhook(std::string_view body);
+
+    /**
+     * @brief Parse a getUpdates response ({"ok":true,"result":[Update, ...]})
+     * @param last_update_id Raised to the highest update_id seen, including skipped updates
+     * @throws std::exception If the body is not valid JSON
+     */
+    static std::vector<IncomingMessage> parse_get_updates(std::string_view body, std::int64_t& last_update_id);
+
+    /**
+     * @brief Streaming form of parse_get_updates that keeps this parser's buffers between calls
+     * @return Messages of this response, valid until the next call; move the elements out to keep them
+     * @throws std::exception If the body is not valid JSON
+     */
+    std::vector<IncomingMessage>& parse(std::string_view body, std::int64_t& last_update_id);
+
+private:
+    std::vector<IncomingMessage> messages_;
+    std::string key_;  ///< Last object key seen by the SAX handler
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef WEBHOOK_SERVER_HPP
+#define WEBHOOK_SERVER_HPP
+
+#include "http_request_parser.hpp"
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Listener settings of the webhook receive mode ([Telegram] Webhook* keys)
+ */
+struct WebhookOptions {
+    std::string address = "127.0.0.1";       ///< Interface to bind; TLS is terminated by the reverse proxy
+    quint16 port = 8443;                     ///< 0 picks a free port
+    std::string path = "/telegram/webhook";  ///< Only POSTs to this path are accepted
+    std::string secret;                      ///< Expected X-Telegram-Bot-Api-Secret-Token, empty disables the check
+};
+
+/**
+ * @class WebhookServer
+ * @brief Embedded HTTP/1.1 endpoint that receives Telegram webhook POSTs
+ *
+ * Runs on the Qt event loop of the thread that owns it: no extra thread and no CPU
+ * while idle. Each accepted body is passed to the handler and answered with 200
+ * right away; keep-alive and pipelined requests are supported.
+ */
+class WebhookServer : public QObject {
+    Q_OBJECT
+
+public:
+    using Handler = std::function<void(const std::string& body)>;
+
+    WebhookServer(WebhookOptions options, Handler handler, QObject* parent = nullptr);
+    ~WebhookServer();
+
+    /**
+     * @brief Start listening
+     * @throws std::runtime_error If the address or port cannot be bound
+     */
+    void listen();
+
+    /**
+     * @brief Stop listening and drop open connections
+     */
+    void close();
+
+    /**
+     * @brief Bound port, useful when the options asked for port 0
+     */
+    quint16 port() const;
+
+    /**
+     * @brief Updates accepted and passed to the handler so far
+     */
+    std::size_t updates_received() const noexcept;
+
+private:
+    void onNewConnection();
+    void onReadyRead(QTcpSocket* socket);
+    int handle(const HttpRequest& request);
+    static void respond(QTcpSocket* socket, int status, bool keep_alive);
+
+    WebhookOptions options_;
+    Handler handler_;
+    QTcpServer server_;
+    std::unordered_map<QTcpSocket*, HttpRequestParser> parsers_;  ///< One per open connection
+    std::size_t updates_ = 0;
+};
+
+#endif
@@ -0,0 +1,199 @@
+#include "async_sender.hpp"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+size_t appendBody(char* data, size_t size, size_t nmemb, void* userp) {
+    const size_t total = size * nmemb;
+    static_cast<std::string*>(userp)->append(data, total);
+    return total;
+}
+
+} // namespace
+
+AsyncSender::AsyncSender(const MessageSender& sender, std::size_t max_in_flight)
+    : sender_(sender),
+      send_url_(sender.method_url("sendMessage")),
+      max_in_flight_(std::max<std::size_t>(max_in_flight, 1))
+{
+    multi_ = curl_multi_init();
+    if (!multi_) {
+        throw std::runtime_error("Failed to initialize CURL multi handle");
+    }
+    // One HTTP/2 connection carries many streams; over HTTP/1.1 each transfer needs its own connection
+    curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(max_in_flight_));
+    curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, static_cast<long>(max_in_flight_));
+
+    in_flight_.reserve(max_in_flight_);
+    thread_ = std::thread(&AsyncSender::run, this);
+}
+
+AsyncSender::~AsyncSender() {
+    stop();
+    in_flight_.clear();
+    idle_handles_.clear();
+    curl_multi_cleanup(multi_);
+}
+
+void AsyncSender::send(std::string chat_id, std::string text, Callback done) {
+    {
+        // Checked under the queue lock so a request can't slip in after abortAll() drained the queue
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (running_) {
+            queue_.push_back({std::move(chat_id), std::move(text), std::move(done)});
+            ++pending_;
+            done = nullptr;
+        }
+    }
+    if (done) {
+        SendResult aborted;
+        aborted.curl_code = CURLE_ABORTED_BY_CALLBACK;
+        complete(done, aborted);
+        return;
+    }
+    curl_multi_wakeup(multi_);
+}
+
+std::future<SendResult> AsyncSender::send(std::string chat_id, std::string text) {
+    auto promise = std::make_shared<std::promise<SendResult>>();
+    std::future<SendResult> future = promise->get_future();
+    send(std::move(chat_id), std::move(text), [promise](const SendResult& result) {
+        promise->set_value(result);
+    });
+    return future;
+}
+
+void AsyncSender::stop() {
+    if (running_.exchange(false)) {
+        curl_multi_wakeup(multi_);
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+std::size_t AsyncSender::pending() const noexcept {
+    return pending_.load();
+}
+
+std::size_t AsyncSender::max_in_flight() const noexcept {
+    return max_in_flight_;
+}
+
+void AsyncSender::run() {
+    while (running_) {
+        startQueued();
+
+        int still_running = 0;
+        curl_multi_perform(multi_, &still_running);
+        finishCompleted();
+
+        // Sleeps until a socket is ready, a timeout expires or send()/stop() calls curl_multi_wakeup
+        curl_multi_poll(multi_, nullptr, 0, 1000, nullptr);
+    }
+    abortAll();
+}
+
+void AsyncSender::startQueued() {
+    // Completed after the lock is released, like every other callback: one may call send()
+    std::vector<std::unique_ptr<Transfer>> rejected;
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    while (!queue_.empty() && in_flight_.size() < max_in_flight_) {
+        Request request = std::move(queue_.front());
+        queue_.pop_front();
+
+        auto transfer = std::make_unique<Transfer>();
+        if (!idle_handles_.empty()) {
+            transfer->handle = std::move(idle_handles_.back());
+            idle_handles_.pop_back();
+        } else {
+            sender_.configure(transfer->handle);
+        }
+        transfer->done = std::move(request.done);
+
+        try {
+            transfer->params = MessageSender::encode_message(transfer->handle, request.chat_id, request.text);
+        } catch (const std::exception&) {
+            transfer->result.curl_code = CURLE_BAD_FUNCTION_ARGUMENT;
+            rejected.push_back(std::move(transfer));
+            continue;
+        }
+
+        CURL* handle = transfer->handle;
+        curl_easy_setopt(handle, CURLOPT_URL, send_url_.c_str());
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDS, transfer->params.c_str());
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE, static_cast<long>(transfer->params.size()));
+        curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, appendBody);
+        curl_easy_setopt(handle, CURLOPT_WRITEDATA, &transfer->result.body);
+        curl_easy_setopt(handle, CURLOPT_PRIVATE, transfer.get());
+
+        curl_multi_add_handle(multi_, handle);
+        in_flight_.push_back(std::move(transfer));
+    }
+    lock.unlock();
+
+    for (auto& transfer : rejected) {
+        --pending_;
+        complete(transfer->done, transfer->result);
+        idle_handles_.push_back(std::move(transfer->handle));
+    }
+}
+
+void AsyncSender::finishCompleted() {
+    int remaining = 0;
+    while (CURLMsg* message = curl_multi_info_read(multi_, &remaining)) {
+        if (message->msg != CURLMSG_DONE) {
+            continue;
+        }
+        Transfer* transfer = nullptr;
+        curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&transfer));
+        transfer->result.curl_code = message->data.result;
+        curl_easy_getinfo(message->easy_handle, CURLINFO_RESPONSE_CODE, &transfer->result.http_status);
+        curl_multi_remove_handle(multi_, message->easy_handle);
+
+        auto it = std::find_if(in_flight_.begin(), in_flight_.end(),
+            [transfer](const std::unique_ptr<Transfer>& t) { return t.get() == transfer; });
+        std::unique_ptr<Transfer> finished = std::move(*it);
+        in_flight_.erase(it);
+
+        --pending_;
+        complete(finished->done, finished->result);
+        idle_handles_.push_back(std::move(finished->handle));  // keeps its connection for the next request
+    }
+}
+
+void AsyncSender::abortAll() {
+    SendResult aborted;
+    aborted.curl_code = CURLE_ABORTED_BY_CALLBACK;
+
+    for (auto& transfer : in_flight_) {
+        curl_multi_remove_handle(multi_, transfer->handle);
+        --pending_;
+        complete(transfer->done, aborted);
+    }
+    in_flight_.clear();
+
+    std::deque<Request> queued;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        queued.swap(queue_);
+    }
+    for (auto& request : queued) {
+        --pending_;
+        complete(request.done, aborted);
+    }
+}
+
+void AsyncSender::complete(const Callback& done, const SendResult& result) noexcept {
+    if (!done) {
+        return;
+    }
+    try {
+        done(result);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] Send completion handler failed: " << e.what() << std::endl;
+    }
+}
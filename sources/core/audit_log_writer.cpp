@@ -0,0 +1,125 @@
+#include "audit_log_writer.hpp"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+AuditLogWriter::AuditLogWriter(Sink sink, const AuditLogOptions& options)
+    : sink_(std::move(sink)), options_(options)
+{
+    if (!sink_) {
+        throw std::invalid_argument("AuditLogWriter requires a sink");
+    }
+    if (options_.capacity == 0 || options_.max_batch == 0) {
+        throw std::invalid_argument("AuditLogWriter capacity and batch size must be positive");
+    }
+    thread_ = std::thread(&AuditLogWriter::run, this);
+}
+
+AuditLogWriter::~AuditLogWriter() {
+    stop();
+}
+
+bool AuditLogWriter::enqueue(LogEntry entry) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || queue_.size() >= options_.capacity) {
+            ++stats_.dropped;
+            return false;
+        }
+        queue_.push_back(std::move(entry));
+        ++enqueued_;
+        // Wake the writer when a time window starts or a batch is full; otherwise it is already waiting
+        if (queue_.size() != 1 && queue_.size() < options_.max_batch) {
+            return true;
+        }
+    }
+    wake_.notify_one();
+    return true;
+}
+
+void AuditLogWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const std::uint64_t target = enqueued_;
+    if (completed_ >= target) {
+        return;
+    }
+    flush_requested_ = true;
+    wake_.notify_one();
+    // The thread drains the whole queue before exiting, so this always completes
+    done_.wait(lock, [&]() { return completed_ >= target; });
+}
+
+void AuditLogWriter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+AuditLogStats AuditLogWriter::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    AuditLogStats stats = stats_;
+    stats.depth = queue_.size();
+    return stats;
+}
+
+void AuditLogWriter::run() {
+    std::vector<LogEntry> batch;
+    batch.reserve(options_.max_batch);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [&]() { return stopping_ || flush_requested_ || !queue_.empty(); });
+
+        // Give the batch a time window to fill unless it is already full or someone is waiting
+        if (!stopping_ && !flush_requested_ && queue_.size() < options_.max_batch) {
+            wake_.wait_for(lock, options_.flush_interval, [&]() {
+                return stopping_ || flush_requested_ || queue_.size() >= options_.max_batch;
+            });
+        }
+
+        if (queue_.empty()) {
+            flush_requested_ = false;
+            if (stopping_) {
+                break;
+            }
+            continue;
+        }
+
+        const std::size_t count = std::min(queue_.size(), options_.max_batch);
+        for (std::size_t i = 0; i < count; ++i) {
+            batch.push_back(std::move(queue_.front()));
+            queue_.pop_front();
+        }
+        if (queue_.empty()) {
+            flush_requested_ = false;
+        }
+
+        lock.unlock();
+        bool ok = true;
+        try {
+            sink_(batch);
+        } catch (const std::exception& e) {
+            ok = false;
+            std::cerr << "[ERROR] Audit log batch of " << batch.size() << " failed: " << e.what() << std::endl;
+        }
+        lock.lock();
+
+        if (ok) {
+            stats_.written += batch.size();
+        } else {
+            stats_.failed += batch.size();
+        }
+        ++stats_.batches;
+        completed_ += batch.size();
+        batch.clear();
+        done_.notify_all();
+    }
+}
@@ -0,0 +1,55 @@
+#include "chat_registry.hpp"
+#include <mutex>
+
+bool ChatRegistry::insert(std::string_view chat_id, const std::function<void()>& persist) {
+    std::unique_lock lock(mutex_);
+    if (chats_.find(chat_id) != chats_.end()) {
+        return false;
+    }
+    if (persist) {
+        persist();
+    }
+    chats_.emplace(chat_id);
+    order_.emplace_back(chat_id);
+    return true;
+}
+
+void ChatRegistry::assign(std::vector<std::string> chat_ids) {
+    std::unordered_set<std::string, Hash, std::equal_to<>> chats(chat_ids.begin(), chat_ids.end());
+    std::unique_lock lock(mutex_);
+    chats_ = std::move(chats);
+    order_ = std::move(chat_ids);
+}
+
+void ChatRegistry::clear() noexcept {
+    std::unique_lock lock(mutex_);
+    chats_.clear();
+    order_.clear();
+}
+
+void ChatRegistry::clear(const std::function<void()>& persist) {
+    std::unique_lock lock(mutex_);
+    persist();
+    chats_.clear();
+    order_.clear();
+}
+
+bool ChatRegistry::contains(std::string_view chat_id) const {
+    std::shared_lock lock(mutex_);
+    return chats_.find(chat_id) != chats_.end();
+}
+
+std::vector<std::string> ChatRegistry::snapshot() const {
+    std::shared_lock lock(mutex_);
+    return order_;
+}
+
+std::string ChatRegistry::first() const {
+    std::shared_lock lock(mutex_);
+    return order_.empty() ? std::string() : order_.front();
+}
+
+std::size_t ChatRegistry::size() const {
+    std::shared_lock lock(mutex_);
+    return order_.size();
+}
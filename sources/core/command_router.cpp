@@ -0,0 +1,121 @@
+#include "command_router.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+bool isSpace(char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+} // namespace
+
+std::chrono::nanoseconds CommandMetrics::mean() const noexcept {
+    return calls ? total / static_cast<std::int64_t>(calls) : std::chrono::nanoseconds(0);
+}
+
+void CommandRouter::add(std::string name, Handler handler, std::vector<Middleware> middleware) {
+    if (name.size() < 2 || name.front() != '/' || name.find_first_of(" \t\n\r@") != std::string::npos) {
+        throw std::invalid_argument("Invalid command name: " + name);
+    }
+    if (!handler) {
+        throw std::invalid_argument("Command " + name + " has no handler");
+    }
+    if (entries_.count(name)) {
+        throw std::invalid_argument("Command already registered: " + name);
+    }
+    order_.push_back(name);
+    entries_.emplace(std::move(name), Entry{std::move(handler), std::move(middleware), {}});
+}
+
+void CommandRouter::set_fallback(Handler handler) {
+    fallback_ = std::move(handler);
+}
+
+bool CommandRouter::dispatch(std::string_view chat_id, std::string_view text) {
+    auto context = parse(chat_id, text);
+    auto it = context ? entries_.find(context->command) : entries_.end();
+    if (it == entries_.end()) {
+        if (fallback_) {
+            fallback_(context.value_or(CommandContext{chat_id, {}, trim(text)}));
+        }
+        return false;
+    }
+
+    Entry& entry = it->second;
+    for (const auto& middleware : entry.middleware) {
+        if (!middleware(*context)) {
+            ++entry.metrics.rejected;
+            return true;
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    auto record = [&entry, start]() {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        ++entry.metrics.calls;
+        entry.metrics.total += elapsed;
+        entry.metrics.max = std::max(entry.metrics.max, elapsed);
+    };
+    try {
+        entry.handler(*context);
+    } catch (...) {
+        record();
+        throw;
+    }
+    record();
+    return true;
+}
+
+std::optional<CommandContext> CommandRouter::parse(std::string_view chat_id, std::string_view text) {
+    text = trim(text);
+    if (text.size() < 2 || text.front() != '/') {
+        return std::nullopt;
+    }
+    std::size_t end = 0;
+    while (end < text.size() && !isSpace(text[end])) {
+        ++end;
+    }
+    std::string_view command = text.substr(0, end);
+    // Groups address commands as /cmd@botname
+    command = command.substr(0, command.find('@'));
+    if (command.size() < 2) {
+        return std::nullopt;
+    }
+    return CommandContext{chat_id, command, trim(text.substr(end))};
+}
+
+std::vector<std::string_view> CommandRouter::split_args(std::string_view args, char delimiter, std::size_t max_parts) {
+    std::vector<std::string_view> parts;
+    if (trim(args).empty() || max_parts == 0) {
+        return parts;
+    }
+    while (parts.size() + 1 < max_parts) {
+        const std::size_t pos = args.find(delimiter);
+        if (pos == std::string_view::npos) {
+            break;
+        }
+        parts.push_back(trim(args.substr(0, pos)));
+        args.remove_prefix(pos + 1);
+    }
+    parts.push_back(trim(args));
+    return parts;
+}
+
+std::string_view CommandRouter::trim(std::string_view s) noexcept {
+    while (!s.empty() && isSpace(s.front())) s.remove_prefix(1);
+    while (!s.empty() && isSpace(s.back())) s.remove_suffix(1);
+    return s;
+}
+
+std::optional<CommandMetrics> CommandRouter::metrics(std::string_view name) const {
+    auto it = entries_.find(name);
+    if (it == entries_.end()) {
+        return std::nullopt;
+    }
+    return it->second.metrics;
+}
+
+const std::vector<std::string>& CommandRouter::commands() const noexcept {
+    return order_;
+}
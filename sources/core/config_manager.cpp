@@ -3,6 +3,7 @@
 #include <sstream>
 #include <algorithm>
 #include <filesystem>
+#include <cctype>
 
 ConfigManager::ConfigManager(const std::string& config_path) : config_path_("config/config.ini")
 {
@@ -15,10 +16,129 @@ std::string ConfigManager::get_bot_token() const {
     return read_key("Telegram", "BotToken");
 }
 
+std::string ConfigManager::get_telegram_api_url() const {
+    std::string url = read_key_or("Telegram", "ApiUrl", "https://api.telegram.org");
+    while (!url.empty() && url.back() == '/') {
+        url.pop_back();
+    }
+    return url;
+}
+
+int ConfigManager::get_telegram_max_in_flight() const {
+    const std::string value = read_key_or("Telegram", "MaxInFlight", "32");
+    try {
+        int limit = std::stoi(value);
+        if (limit < 1) {
+            throw std::out_of_range(value);
+        }
+        return limit;
+    } catch (const std::exception&) {
+        throw std::runtime_error("Invalid [Telegram] MaxInFlight: " + value);
+    }
+}
+
+std::vector<std::chrono::seconds> ConfigManager::get_deadline_leads() const {
+    const std::string value = read_key_or("Telegram", "DeadlineLeads", "24h, 1h, 10m");
+    std::vector<std::chrono::seconds> leads;
+    std::stringstream entries(value);
+    std::string entry;
+    while (std::getline(entries, entry, ',')) {
+        entry.erase(std::remove_if(entry.begin(), entry.end(),
+            [](unsigned char c) { return std::isspace(c); }), entry.end());
+        if (entry.empty()) {
+            continue;
+        }
+        try {
+            std::size_t used = 0;
+            long long amount = std::stoll(entry, &used);
+            const std::string unit = entry.substr(used);
+            long long scale = unit == "s" ? 1 : unit == "m" ? 60 : unit == "h" ? 3600 : unit == "d" ? 86400 : 0;
+            if (amount <= 0 || scale == 0) {
+                throw std::out_of_range(entry);
+            }
+            leads.emplace_back(amount * scale);
+        } catch (const std::exception&) {
+            throw std::runtime_error("Invalid [Telegram] DeadlineLeads entry: " + entry);
+        }
+    }
+    return leads;
+}
+
+std::string ConfigManager::get_telegram_mode() const {
+    std::string mode = read_key_or("Telegram", "Mode", "polling");
+    std::transform(mode.begin(), mode.end(), mode.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (mode != "polling" && mode != "webhook") {
+        throw std::runtime_error("Invalid [Telegram] Mode: " + mode);
+    }
+    return mode;
+}
+
+std::string ConfigManager::get_webhook_address() const {
+    return read_key_or("Telegram", "WebhookAddress", "127.0.0.1");
+}
+
+int ConfigManager::get_webhook_port() const {
+    const std::string value = read_key_or("Telegram", "WebhookPort", "8443");
+    try {
+        int port = std::stoi(value);
+        if (port < 0 || port > 65535) {
+            throw std::out_of_range(value);
+        }
+        return port;
+    } catch (const std::exception&) {
+        throw std::runtime_error("Invalid [Telegram] WebhookPort: " + value);
+    }
+}
+
+std::string ConfigManager::get_webhook_path() const {
+    std::string path = read_key_or("Telegram", "WebhookPath", "/telegram/webhook");
+    if (path.empty() || path.front() != '/') {
+        path.insert(path.begin(), '/');
+    }
+    return path;
+}
+
+std::string ConfigManager::get_webhook_secret() const {
+    return read_key_or("Telegram", "WebhookSecret", "");
+}
+
 std::string ConfigManager::get_db_path() const {
     return read_key("Database", "Path");
 }
 
+std::string ConfigManager::get_db_journal_mode() const {
+    std::string mode = read_key_or("Database", "JournalMode", "DELETE");
+    std::transform(mode.begin(), mode.end(), mode.begin(),
+        [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return mode;
+}
+
+int ConfigManager::get_db_read_pool_size() const {
+    const std::string value = read_key_or("Database", "ReadPoolSize", "0");
+    try {
+        int size = std::stoi(value);
+        if (size < 0) {
+            throw std::out_of_range(value);
+        }
+        return size;
+    } catch (const std::exception&) {
+        throw std::runtime_error("Invalid [Database] ReadPoolSize: " + value);
+    }
+}
+
+std::string ConfigManager::get_db_synchronous() const {
+    return read_key_or("Database", "Synchronous", "FULL");
+}
+
+std::string ConfigManager::read_key_or(const std::string& section, const std::string& key, const std::string& fallback) const {
+    try {
+        return read_key(section, key);
+    } catch (const std::runtime_error&) {
+        return fallback;
+    }
+}
+
 std::string ConfigManager::read_key(const std::string& section, const std::string& key) const {
     std::ifstream file(config_path_);
     if (!file.is_open()) {
@@ -30,6 +150,10 @@ std::string ConfigManager::read_key(const std::string& section, const std::strin
     
     while (std::getline(file, line)) {
         line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
+        size_t comment = line.find(';');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
         if (line.empty()) continue;
         
         if (line[0] == '[' && line.back() == ']') {
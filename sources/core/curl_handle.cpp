@@ -33,3 +33,37 @@ CurlHandle& CurlHandle::operator=(CurlHandle&& other) noexcept {
 CurlHandle::operator CURL*() const noexcept {
     return handle_;
 }
+
+CurlMultiHandle::CurlMultiHandle() : handle_(curl_multi_init()) {
+    if (!handle_) {
+        throw std::runtime_error("Failed to initialize CURL multi handle");
+    }
+}
+
+CurlMultiHandle::~CurlMultiHandle() {
+    cleanup();
+}
+
+void CurlMultiHandle::cleanup() noexcept {
+    if (handle_) {
+        curl_multi_cleanup(handle_);
+        handle_ = nullptr;
+    }
+}
+
+CurlMultiHandle::CurlMultiHandle(CurlMultiHandle&& other) noexcept : handle_(other.handle_) {
+    other.handle_ = nullptr;
+}
+
+CurlMultiHandle& CurlMultiHandle::operator=(CurlMultiHandle&& other) noexcept {
+    if (this != &other) {
+        cleanup();
+        handle_ = other.handle_;
+        other.handle_ = nullptr;
+    }
+    return *this;
+}
+
+CurlMultiHandle::operator CURLM*() const noexcept {
+    return handle_;
+}
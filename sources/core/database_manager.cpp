@@ -1,11 +1,201 @@
 #include "database_manager.hpp"
 #include "task.hpp"
+#include "sqlite_transaction.hpp"
+#include "schema_migrator.hpp"
+#include "execution_history.hpp"
 #include <sqlite3.h>
 #include <stdexcept>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <cctype>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+// Binds without copying: every caller's string outlives the CachedStatement lease,
+// which clears the bindings before it is released
+void bindText(sqlite3_stmt* stmt, int index, std::string_view value) {
+    sqlite3_bind_text(stmt, index, value.data(), static_cast<int>(value.size()), SQLITE_STATIC);
+}
+
+// Schema history, oldest first. Never edit a released migration: append a new one instead.
+// Version 1 uses IF NOT EXISTS so that files created before user_version was tracked upgrade cleanly.
+void registerMigrations(SchemaMigrator& migrator) {
+    migrator.add(1, "initial schema",
+        "CREATE TABLE IF NOT EXISTS tasks ("
+        "id TEXT PRIMARY KEY, "
+        "type INTEGER NOT NULL, "  // 0, 1 or 2
+        "status INTEGER NOT NULL DEFAULT 0, "  // 0, 1 or 2
+        "title TEXT NOT NULL, "
+        "description TEXT, "
+        "created_at INTEGER, "
+        "deadline INTEGER, "
+        "priority INTEGER, "
+        "base_interval_seconds INTEGER, "
+        "end_date INTEGER, "
+        "last_execution INTEGER, "
+        "next_execution INTEGER"
+        ");"
+        "CREATE TABLE IF NOT EXISTS telegram_chats ("
+        "chat_id TEXT PRIMARY KEY"
+        ");"
+        "CREATE TABLE IF NOT EXISTS templates ("
+        "id TEXT PRIMARY KEY, "
+        "title TEXT NOT NULL, "
+        "description TEXT, "
+        "interval_hours INTEGER DEFAULT 0);"
+        "CREATE TABLE IF NOT EXISTS logs ("
+        "timestamp DATETIME DEFAULT CURRENT_TIMESTAMP, "
+        "action_type TEXT, "
+        "task_id TEXT, "
+        "message TEXT);");
+
+    migrator.add(2, "task indexes",
+        "CREATE INDEX IF NOT EXISTS idx_tasks_status_type ON tasks(status, type);"
+        "CREATE INDEX IF NOT EXISTS idx_tasks_deadline ON tasks(status, deadline);"
+        "CREATE INDEX IF NOT EXISTS idx_tasks_next_execution ON tasks(status, next_execution);");
+
+    // Recurring tasks saved before next_execution was filled in
+    migrator.add(3, "backfill next_execution",
+        "UPDATE tasks SET next_execution = COALESCE(last_execution, created_at) + base_interval_seconds "
+        "WHERE type = 2 AND next_execution IS NULL AND base_interval_seconds > 0;");
+
+    // Chat that created the task through the bot; NULL for tasks created in the GUI
+    migrator.add(4, "task owner",
+        "ALTER TABLE tasks ADD COLUMN owner_chat_id TEXT;"
+        "CREATE INDEX IF NOT EXISTS idx_tasks_owner ON tasks(owner_chat_id, status);");
+
+    // next_execution was bound to NULL by every write until it became the reminder queue
+    migrator.add(5, "refill next_execution",
+        "UPDATE tasks SET next_execution = COALESCE(last_execution, created_at) + base_interval_seconds "
+        "WHERE type = 2 AND status = 0 AND next_execution IS NULL AND base_interval_seconds > 0;"
+        "UPDATE tasks SET next_execution = NULL WHERE next_execution > end_date;");
+
+    // Deadline reminders: one row per (task, lead) still ahead, maintained by triggers on tasks.
+    // The leads mirror the [Telegram] DeadlineLeads default; the bot replaces them at startup.
+    migrator.add(6, "deadline reminders",
+        "CREATE TABLE deadline_leads (lead_seconds INTEGER PRIMARY KEY);"
+        "INSERT INTO deadline_leads VALUES (86400), (3600), (600);"
+        "CREATE TABLE scheduled_events ("
+        "task_id TEXT NOT NULL, "
+        "lead_seconds INTEGER NOT NULL, "
+        "fire_at INTEGER NOT NULL, "
+        "PRIMARY KEY (task_id, lead_seconds));"
+        "CREATE INDEX idx_scheduled_events_fire_at ON scheduled_events(fire_at);"
+        "CREATE TRIGGER tasks_events_insert AFTER INSERT ON tasks "
+        "WHEN NEW.type = 1 AND NEW.status = 0 AND NEW.deadline IS NOT NULL BEGIN "
+        "INSERT OR REPLACE INTO scheduled_events (task_id, lead_seconds, fire_at) "
+        "SELECT NEW.id, lead_seconds, NEW.deadline - lead_seconds FROM deadline_leads "
+        "WHERE NEW.deadline - lead_seconds > CAST(strftime('%s', 'now') AS INTEGER); "
+        "END;"
+        "CREATE TRIGGER tasks_events_update AFTER UPDATE OF type, status, deadline ON tasks BEGIN "
+        "DELETE FROM scheduled_events WHERE task_id = OLD.id; "
+        "INSERT OR REPLACE INTO scheduled_events (task_id, lead_seconds, fire_at) "
+        "SELECT NEW.id, lead_seconds, NEW.deadline - lead_seconds FROM deadline_leads "
+        "WHERE NEW.type = 1 AND NEW.status = 0 AND NEW.deadline IS NOT NULL "
+        "AND NEW.deadline - lead_seconds > CAST(strftime('%s', 'now') AS INTEGER); "
+        "END;"
+        "CREATE TRIGGER tasks_events_delete AFTER DELETE ON tasks BEGIN "
+        "DELETE FROM scheduled_events WHERE task_id = OLD.id; "
+        "END;"
+        // Deadline tasks already in the file get their remaining reminders
+        "INSERT INTO scheduled_events (task_id, lead_seconds, fire_at) "
+        "SELECT t.id, l.lead_seconds, t.deadline - l.lead_seconds FROM tasks t, deadline_leads l "
+        "WHERE t.type = 1 AND t.status = 0 AND t.deadline IS NOT NULL "
+        "AND t.deadline - l.lead_seconds > CAST(strftime('%s', 'now') AS INTEGER);");
+
+    // Every execution written to tasks.last_execution, as one delta-encoded blob per task
+    // (see ExecutionHistory). DatabaseManager appends on its write paths; the schema itself is
+    // plain SQL, so any other connection can still write tasks.
+    migrator.add(7, "execution history", [](sqlite3* db) {
+        SchemaMigrator::exec(db,
+            "CREATE TABLE execution_history ("
+            "task_id TEXT PRIMARY KEY, "
+            "executions INTEGER NOT NULL, "
+            "last_execution INTEGER NOT NULL, "
+            "deltas BLOB NOT NULL);"
+            "CREATE TRIGGER tasks_history_delete AFTER DELETE ON tasks BEGIN "
+            "DELETE FROM execution_history WHERE task_id = OLD.id; "
+            "END;");
+
+        // Only the last execution of existing tasks was ever stored
+        sqlite3_stmt* select = nullptr;
+        sqlite3_stmt* insert = nullptr;
+        auto finalize = [&]() {
+            sqlite3_finalize(select);
+            sqlite3_finalize(insert);
+        };
+        if (sqlite3_prepare_v2(db, "SELECT id, last_execution FROM tasks WHERE last_execution IS NOT NULL;",
+                               -1, &select, nullptr) != SQLITE_OK ||
+            sqlite3_prepare_v2(db, "INSERT INTO execution_history VALUES (?, 1, ?, ?);", -1, &insert, nullptr) != SQLITE_OK) {
+            const std::string message = sqlite3_errmsg(db);
+            finalize();
+            throw std::runtime_error("SQLite error (prepare history backfill): " + message);
+        }
+        ExecutionHistory::Blob blob;
+        int rc;
+        while ((rc = sqlite3_step(select)) == SQLITE_ROW) {
+            const std::int64_t last = sqlite3_column_int64(select, 1);
+            blob.clear();
+            ExecutionHistory::append(blob, 0, last);
+            sqlite3_reset(insert);
+            sqlite3_bind_value(insert, 1, sqlite3_column_value(select, 0));
+            sqlite3_bind_int64(insert, 2, last);
+            sqlite3_bind_blob(insert, 3, blob.data(), static_cast<int>(blob.size()), SQLITE_STATIC);
+            if (sqlite3_step(insert) != SQLITE_DONE) {
+                rc = SQLITE_ERROR;
+                break;
+            }
+        }
+        if (rc != SQLITE_DONE) {
+            const std::string message = sqlite3_errmsg(db);
+            finalize();
+            throw std::runtime_error("SQLite error (history backfill): " + message);
+        }
+        finalize();
+    });
+}
+
+// Captured by a single reference so the SQL builder fits std::function's small buffer (no allocation per lookup)
+struct SqlParts {
+    const char* prefix;
+    const std::string& table;
+    const char* suffix;
+
+    std::string build() const {
+        return std::string(prefix) + table + suffix;
+    }
+};
+
+std::string_view columnText(sqlite3_stmt* stmt, int column) {
+    const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));
+    if (!text) {
+        return {};
+    }
+    return std::string_view(text, static_cast<std::size_t>(sqlite3_column_bytes(stmt, column)));
+}
+
+// Only the main table feeds TaskStatistics; copies written to other tables are not counted
+bool isStatisticsTable(const std::string& table_name) {
+    return table_name == "tasks";
+}
+
+std::string normalizeSynchronous(std::string level) {
+    std::transform(level.begin(), level.end(), level.begin(),
+        [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    if (level != "OFF" && level != "NORMAL" && level != "FULL" && level != "EXTRA") {
+        throw std::invalid_argument("Unknown synchronous level: " + level);
+    }
+    return level;
+}
+
+} // namespace
+
+DatabaseManager::DatabaseManager(const std::string& db_path, const DatabaseOptions& options) : db_(nullptr) {
+    const std::string synchronous = normalizeSynchronous(options.synchronous);
 
-DatabaseManager::DatabaseManager(const std::string& db_path) : db_(nullptr) {
     int rc = sqlite3_open_v2(
         db_path.c_str(),
         &db_,
@@ -21,8 +211,22 @@ DatabaseManager::DatabaseManager(const std::string& db_path) : db_(nullptr) {
     }
     
     try {
+        statements_ = std::make_unique<StatementCache>(db_);
+        sqlite3_busy_timeout(db_, options.busy_timeout_ms);
+        executeQuery("PRAGMA synchronous = " + synchronous + ";");
         initialize();
+        refreshStatistics();
+        loadChatIds();
+        configureConnection(db_path, options);
+        if (options.async_log) {
+            log_writer_ = std::make_unique<AuditLogWriter>(
+                [this](const std::vector<LogEntry>& entries) { writeLogBatch(entries); },
+                options.log
+            );
+        }
     } catch (...) {
+        readers_.reset();
+        statements_.reset();
         sqlite3_close_v2(db_);
         db_ = nullptr;
         throw;
@@ -30,94 +234,70 @@ DatabaseManager::DatabaseManager(const std::string& db_path) : db_(nullptr) {
 }
 
 DatabaseManager::~DatabaseManager() {
+    log_writer_.reset();    // writes pending log entries while the connection is still open
+    readers_.reset();
+    statements_.reset();
     if (db_) {
         sqlite3_close_v2(db_);
         db_ = nullptr;
     }
 }
 
-void DatabaseManager::initialize() {
-    try {
-        executeQuery("PRAGMA foreign_keys = ON;");
-        
-        executeQuery(
-            "CREATE TABLE IF NOT EXISTS tasks ("
-            "id TEXT PRIMARY KEY, "
-            "type INTEGER NOT NULL, "  // 0, 1 or 2
-            "status INTEGER NOT NULL DEFAULT 0, "  // 0, 1 or 2
-            "title TEXT NOT NULL, "
-            "description TEXT, "
-            "created_at INTEGER, "
-            "deadline INTEGER, "
-            "priority INTEGER, "
-            "base_interval_seconds INTEGER, "
-            "end_date INTEGER, "
-            "last_execution INTEGER, "
-            "next_execution INTEGER"
-            ");"
-        );
-
-        executeQuery(
-            "CREATE TABLE IF NOT EXISTS telegram_chats ("
-            "chat_id TEXT PRIMARY KEY"
-            ");"
-        );
-
-        executeQuery(
-            "CREATE TABLE IF NOT EXISTS templates ("
-            "id TEXT PRIMARY KEY, "
-            "title TEXT NOT NULL, "
-            "description TEXT, "
-            "interval_hours INTEGER DEFAULT 0);"
-        );
-
-        executeQuery(
-            "CREATE TABLE IF NOT EXISTS logs ("
-            "timestamp DATETIME DEFAULT CURRENT_TIMESTAMP, "
-            "action_type TEXT, "
-            "task_id TEXT, "
-            "message TEXT);"
-        );
-    } catch (const std::exception& e) {
-        std::cerr << "Ошибка инициализации БД: " << e.what() << std::endl;
-        throw;
+void DatabaseManager::configureConnection(const std::string& db_path, const DatabaseOptions& options) {
+    if (!options.wal) {
+        return;
     }
-}
 
-void DatabaseManager::addColumnIfNotExists(const std::string& table, const std::string& column, const std::string& type) {
-    std::string checkSql = 
-        "SELECT COUNT(*) FROM pragma_table_info('" + table + "') "
-        "WHERE name = '" + column + "'";
-    
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, checkSql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        throw std::runtime_error("Failed to check column existence");
+    std::string mode;
+    {
+        std::lock_guard<std::recursive_mutex> lock(statements_->mutex());
+        sqlite3_stmt* stmt = nullptr;
+        int rc = sqlite3_prepare_v2(db_, "PRAGMA journal_mode = WAL;", -1, &stmt, nullptr);
+        throwOnError(rc, "prepare journal_mode");
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            mode = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        }
+        sqlite3_finalize(stmt);
     }
 
-    bool columnExists = false;
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        columnExists = (sqlite3_column_int(stmt, 0) > 0);
+    // In-memory and temporary databases cannot use WAL; they keep the single connection
+    wal_enabled_ = (mode == "wal");
+    if (wal_enabled_ && options.read_pool_size > 0) {
+        readers_ = std::make_unique<ReadConnectionPool>(db_path, options.read_pool_size, options.busy_timeout_ms);
     }
-    sqlite3_finalize(stmt);
+}
 
-    if (!columnExists) {
-        std::string alterSql = 
-            "ALTER TABLE " + table + 
-            " ADD COLUMN " + column + " " + type;
-        executeQuery(alterSql);
+bool DatabaseManager::isWalEnabled() const noexcept {
+    return wal_enabled_;
+}
+
+std::size_t DatabaseManager::readPoolSize() const noexcept {
+    return readers_ ? readers_->size() : 0;
+}
+
+void DatabaseManager::initialize() {
+    try {
+        executeQuery("PRAGMA foreign_keys = ON;");
+
+        SchemaMigrator migrator(db_, statements_->mutex());
+        registerMigrations(migrator);
+        migrator.migrate();
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка инициализации БД: " << e.what() << std::endl;
+        throw;
     }
 }
 
-void DatabaseManager::throwOnError(int rc, const std::string& context) const {
+void DatabaseManager::throwOnError(int rc, const std::string& context, sqlite3* db) const {
     if (rc != SQLITE_OK && rc != SQLITE_ROW && rc != SQLITE_DONE) {
         std::ostringstream oss;
-        oss << "SQLite error (" << context << "): " << sqlite3_errmsg(db_);
+        oss << "SQLite error (" << context << "): " << sqlite3_errmsg(db ? db : db_);
         throw std::runtime_error(oss.str());
     }
 }
 
 void DatabaseManager::executeQuery(const std::string& sql, const std::vector<std::string>& params) {
+    std::lock_guard<std::recursive_mutex> lock(statements_->mutex());
     sqlite3_stmt* stmt;
     int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
     throwOnError(rc, "prepare query");
@@ -134,61 +314,372 @@ void DatabaseManager::executeQuery(const std::string& sql, const std::vector<std
     sqlite3_finalize(stmt);
 }
 
+CachedStatement DatabaseManager::cachedStatement(Query query, const std::string& table_name, const char* sql_prefix, const char* sql_suffix) const {
+    SqlParts parts{sql_prefix, table_name, sql_suffix};
+    return statements_->acquire(static_cast<int>(query), table_name, [&parts]() { return parts.build(); });
+}
+
+CachedStatement DatabaseManager::cachedStatement(Query query, const char* sql) const {
+    return statements_->acquire(static_cast<int>(query), std::string(), [sql]() {
+        return std::string(sql);
+    });
+}
+
+CachedStatement DatabaseManager::readStatement(Query query, const std::string& table_name, const char* sql_prefix, const char* sql_suffix) const {
+    if (!readers_) {
+        return cachedStatement(query, table_name, sql_prefix, sql_suffix);
+    }
+    SqlParts parts{sql_prefix, table_name, sql_suffix};
+    return readers_->acquire(static_cast<int>(query), table_name, [&parts]() { return parts.build(); });
+}
+
+CachedStatement DatabaseManager::readStatement(Query query, const char* sql) const {
+    if (!readers_) {
+        return cachedStatement(query, sql);
+    }
+    return readers_->acquire(static_cast<int>(query), std::string(), [sql]() {
+        return std::string(sql);
+    });
+}
+
 void DatabaseManager::saveTask(const Task& task, const std::string& table_name) {
-    const std::string sql = 
-        "INSERT INTO " + table_name + " VALUES (?,?,?,?,?,?,?,?,?,?,?,?);";
-    executeTaskQuery(sql, task);
+    const bool tracked = isStatisticsTable(table_name);
+    const auto last_execution = task.get_tracker().get_last_execution();
+    std::optional<SqliteTransaction> transaction;
+    if (tracked && last_execution) {
+        transaction.emplace(db_, statements_->mutex());  // the row and its history commit together
+    }
+    CachedStatement stmt = cachedStatement(Query::InsertTask, table_name,
+        "INSERT INTO ", " VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?);");
+    executeTaskStatement(stmt, task);
+    if (transaction) {
+        appendExecution(task.get_id_view(), *last_execution);
+        transaction->commit();
+    }
+    if (tracked) {
+        stats_.add(task.get_status(), task.get_type());
+        notifyTaskObservers(TaskChange::Saved, task.get_id_view(), &task);
+    }
 }
 
 void DatabaseManager::updateTask(const Task& task, const std::string& table_name) {
-    const std::string sql = 
-        "UPDATE " + table_name + " SET "
-        "type=?,status=?,title=?,description=?,created_at=?,"
-        "deadline=?,priority=?,base_interval_seconds=?,"
-        "end_date=?,last_execution=?,next_execution=? "
-        "WHERE id=?;";
-    executeTaskQuery(sql, task);
+    // Numbered parameters follow bindTaskParameters(); created_at (?6) is kept as stored
+    CachedStatement stmt = cachedStatement(Query::UpdateTask, table_name,
+        "UPDATE ",
+        " SET "
+        "type=?2,status=?3,title=?4,description=?5,"
+        "deadline=?7,priority=?8,base_interval_seconds=?9,"
+        "end_date=?10,last_execution=?11,next_execution=?12,owner_chat_id=?13 "
+        "WHERE id=?1;");
+    if (!isStatisticsTable(table_name)) {
+        executeTaskStatement(stmt, task);
+        return;
+    }
+
+    // The lease holds the writer lock, so the row cannot change between the two statements
+    const auto last_execution = task.get_tracker().get_last_execution();
+    std::optional<SqliteTransaction> transaction;
+    if (last_execution) {
+        transaction.emplace(db_, statements_->mutex());
+    }
+    auto stored = storedStatusType(task.get_id_view());
+    executeTaskStatement(stmt, task);
+    const bool changed = sqlite3_changes(db_) > 0;
+    if (transaction) {
+        if (changed) {
+            appendExecution(task.get_id_view(), *last_execution);
+        }
+        transaction->commit();
+    }
+    if (stored && changed) {
+        stats_.remove(stored->first, stored->second);
+        stats_.add(task.get_status(), task.get_type());
+        notifyTaskObservers(TaskChange::Updated, task.get_id_view(), &task);
+    }
 }
 
 void DatabaseManager::deleteTask(const std::string& id, const std::string& table_name) {
-    const std::string sql = "DELETE FROM tasks WHERE id = ?;";
-    sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-    throwOnError(rc, "prepare DELETE task");
-    sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_TRANSIENT);
-    rc = sqlite3_step(stmt);
+    CachedStatement stmt = cachedStatement(Query::DeleteTask, table_name,
+        "DELETE FROM ", " WHERE id = ?;");
+    auto stored = isStatisticsTable(table_name) ? storedStatusType(id) : std::nullopt;
+    bindText(stmt, 1, id);
+    int rc = sqlite3_step(stmt);
     if (rc != SQLITE_DONE) {
         throwOnError(rc, "execute DELETE task");
     }
-    sqlite3_finalize(stmt);
+    if (stored && sqlite3_changes(db_) > 0) {
+        stats_.remove(stored->first, stored->second);
+        notifyTaskObservers(TaskChange::Deleted, id, nullptr);
+    }
 }
 
-void DatabaseManager::logAction(const std::string& action_type, const std::string& task_id, const std::string& message) {
-    const std::string sql = 
-        "INSERT INTO logs (action_type, task_id, message) "
-        "VALUES (?, ?, ?);";
-    
-    sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-    throwOnError(rc, "prepare INSERT log");
-
-    sqlite3_bind_text(stmt, 1, action_type.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, task_id.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 3, message.c_str(), -1, SQLITE_TRANSIENT);
+int DatabaseManager::completeTask(std::string_view id, PeriodicTracker::TimePoint when, OwnerFilter owner) {
+    // RETURNING hands the changed row to the observers without a second query
+    SqliteTransaction transaction(db_, statements_->mutex());
+    CachedStatement stmt = owner
+        ? cachedStatement(Query::CompleteTaskForOwner,
+              "UPDATE tasks SET status = CASE WHEN type = 2 THEN status ELSE ?2 END, last_execution = ?3 "
+              "WHERE id = ?1 AND (owner_chat_id = ?4 OR owner_chat_id IS NULL) RETURNING *;")
+        : cachedStatement(Query::CompleteTask,
+              "UPDATE tasks SET status = CASE WHEN type = 2 THEN status ELSE ?2 END, last_execution = ?3 "
+              "WHERE id = ?1 RETURNING *;");
+    auto stored = storedStatusType(id);
+    bindText(stmt, 1, id);
+    sqlite3_bind_int(stmt, 2, static_cast<int>(Task::Status::Completed));
+    sqlite3_bind_int64(stmt, 3, std::chrono::system_clock::to_time_t(when));
+    if (owner) {
+        bindText(stmt, 4, *owner);
+    }
 
+    int rc = sqlite3_step(stmt);
+    if (rc == SQLITE_DONE) {
+        return 0;
+    }
+    if (rc != SQLITE_ROW) {
+        throwOnError(rc, "execute UPDATE complete task");
+    }
+    Task task;
+    mapTaskFromRow(stmt, task);
     rc = sqlite3_step(stmt);
     if (rc != SQLITE_DONE) {
-        throwOnError(rc, "execute INSERT log");
+        throwOnError(rc, "execute UPDATE complete task");
     }
-    sqlite3_finalize(stmt);
+    if (task.is_recurring()) {
+        // Completing a recurring task is one run of it: the reminders go on from there
+        advanceSchedule(task, when, std::nullopt);
+        CachedStatement next_stmt = cachedStatement(Query::SetNextExecution,
+            "UPDATE tasks SET next_execution = ?2 WHERE id = ?1;");
+        bindText(next_stmt, 1, id);
+        if (auto next = task.next_execution_time(when)) {
+            sqlite3_bind_int64(next_stmt, 2, std::chrono::system_clock::to_time_t(*next));
+        } else {
+            sqlite3_bind_null(next_stmt, 2);
+        }
+        rc = sqlite3_step(next_stmt);
+        if (rc != SQLITE_DONE) {
+            throwOnError(rc, "execute UPDATE next execution");
+        }
+    }
+    appendExecution(id, when);
+    transaction.commit();
+
+    if (stored) {
+        stats_.remove(stored->first, stored->second);
+        stats_.add(task.get_status(), task.get_type());
+    }
+    notifyTaskObservers(TaskChange::Updated, task.get_id_view(), &task);
+    return 1;
+}
+
+DatabaseManager::BatchResult DatabaseManager::saveTasks(std::span<const Task> tasks, BatchMode mode, const std::string& table_name) {
+    CachedStatement stmt = cachedStatement(Query::InsertTask, table_name,
+        "INSERT INTO ", " VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?);");
+    const bool tracked = isStatisticsTable(table_name);
+    TaskStatistics::Delta delta;
+    std::vector<std::size_t> written;
+    auto result = executeBatch(stmt, tasks.size(), mode, [&](sqlite3_stmt* s, std::size_t i) {
+        bindTaskParameters(s, tasks[i]);
+    }, "batch INSERT task", [&](std::size_t i) {
+        delta.add(tasks[i].get_status(), tasks[i].get_type());
+        written.push_back(i);
+        if (tracked) {
+            if (auto last_execution = tasks[i].get_tracker().get_last_execution()) {
+                appendExecution(tasks[i].get_id_view(), *last_execution);
+            }
+        }
+    });
+    if (tracked) {
+        stats_.apply(delta);  // only after the commit, so a rolled back batch leaves the counters untouched
+        for (std::size_t i : written) {
+            notifyTaskObservers(TaskChange::Saved, tasks[i].get_id_view(), &tasks[i]);
+        }
+    }
+    return result;
+}
+
+DatabaseManager::BatchResult DatabaseManager::updateTasks(std::span<const Task> tasks, BatchMode mode, const std::string& table_name) {
+    CachedStatement stmt = cachedStatement(Query::UpdateTask, table_name,
+        "UPDATE ",
+        " SET "
+        "type=?2,status=?3,title=?4,description=?5,"
+        "deadline=?7,priority=?8,base_interval_seconds=?9,"
+        "end_date=?10,last_execution=?11,next_execution=?12,owner_chat_id=?13 "
+        "WHERE id=?1;");
+    const bool tracked = isStatisticsTable(table_name);
+    TaskStatistics::Delta delta;
+    std::optional<std::pair<Task::Status, Task::Type>> stored;
+    std::vector<std::size_t> changed;
+    auto result = executeBatch(stmt, tasks.size(), mode, [&](sqlite3_stmt* s, std::size_t i) {
+        stored = tracked ? storedStatusType(tasks[i].get_id_view()) : std::nullopt;
+        bindTaskParameters(s, tasks[i]);
+    }, "batch UPDATE task", [&](std::size_t i) {
+        if (stored && sqlite3_changes(db_) > 0) {
+            delta.remove(stored->first, stored->second);
+            delta.add(tasks[i].get_status(), tasks[i].get_type());
+            changed.push_back(i);
+            if (auto last_execution = tasks[i].get_tracker().get_last_execution()) {
+                appendExecution(tasks[i].get_id_view(), *last_execution);
+            }
+        }
+    });
+    stats_.apply(delta);
+    for (std::size_t i : changed) {
+        notifyTaskObservers(TaskChange::Updated, tasks[i].get_id_view(), &tasks[i]);
+    }
+    return result;
+}
+
+DatabaseManager::BatchResult DatabaseManager::deleteTasks(std::span<const std::string> ids, BatchMode mode, const std::string& table_name) {
+    CachedStatement stmt = cachedStatement(Query::DeleteTask, table_name,
+        "DELETE FROM ", " WHERE id = ?;");
+    const bool tracked = isStatisticsTable(table_name);
+    TaskStatistics::Delta delta;
+    std::optional<std::pair<Task::Status, Task::Type>> stored;
+    std::vector<std::size_t> removed;
+    auto result = executeBatch(stmt, ids.size(), mode, [&](sqlite3_stmt* s, std::size_t i) {
+        stored = tracked ? storedStatusType(ids[i]) : std::nullopt;
+        bindText(s, 1, ids[i]);
+    }, "batch DELETE task", [&](std::size_t i) {
+        if (stored && sqlite3_changes(db_) > 0) {
+            delta.remove(stored->first, stored->second);
+            removed.push_back(i);
+        }
+    });
+    stats_.apply(delta);
+    for (std::size_t i : removed) {
+        notifyTaskObservers(TaskChange::Deleted, ids[i], nullptr);
+    }
+    return result;
+}
+
+void DatabaseManager::appendExecution(std::string_view task_id, PeriodicTracker::TimePoint when) {
+    const std::int64_t timestamp = std::chrono::system_clock::to_time_t(when);
+    std::optional<std::int64_t> previous;
+    {
+        CachedStatement stmt = cachedStatement(Query::SelectHistoryLast,
+            "SELECT last_execution FROM execution_history WHERE task_id = ?;");
+        bindText(stmt, 1, task_id);
+        int rc = sqlite3_step(stmt);
+        if (rc == SQLITE_ROW) {
+            previous = sqlite3_column_int64(stmt, 0);
+        } else {
+            throwOnError(rc, "execute SELECT history last execution");
+        }
+    }
+    if (previous == timestamp) {
+        return;  // the task was rewritten with the same last execution
+    }
+
+    // Only the new delta is encoded; the stored bytes are extended in place
+    ExecutionHistory::Blob delta;
+    ExecutionHistory::append(delta, previous.value_or(0), timestamp);
+    CachedStatement stmt = cachedStatement(Query::AppendHistory,
+        "INSERT INTO execution_history (task_id, executions, last_execution, deltas) VALUES (?1, 1, ?2, ?3) "
+        "ON CONFLICT (task_id) DO UPDATE SET executions = executions + 1, "
+        "last_execution = excluded.last_execution, deltas = CAST(deltas || excluded.deltas AS BLOB);");
+    bindText(stmt, 1, task_id);
+    sqlite3_bind_int64(stmt, 2, timestamp);
+    sqlite3_bind_blob(stmt, 3, delta.data(), static_cast<int>(delta.size()), SQLITE_STATIC);
+    int rc = sqlite3_step(stmt);
+    if (rc != SQLITE_DONE) {
+        throwOnError(rc, "execute INSERT execution history");
+    }
+}
+
+std::optional<std::pair<Task::Status, Task::Type>> DatabaseManager::storedStatusType(std::string_view id) {
+    CachedStatement stmt = cachedStatement(Query::SelectStatusType,
+        "SELECT status, type FROM tasks WHERE id = ?;");
+    bindText(stmt, 1, id);
+    int rc = sqlite3_step(stmt);
+    if (rc != SQLITE_ROW) {
+        throwOnError(rc, "execute SELECT task status");
+        return std::nullopt;
+    }
+    return std::make_pair(static_cast<Task::Status>(sqlite3_column_int(stmt, 0)),
+                          static_cast<Task::Type>(sqlite3_column_int(stmt, 1)));
+}
+
+DatabaseManager::BatchResult DatabaseManager::executeBatch(CachedStatement& stmt, std::size_t count, BatchMode mode,
+                                                           const std::function<void(sqlite3_stmt*, std::size_t)>& bind,
+                                                           const char* context,
+                                                           const std::function<void(std::size_t)>& written) {
+    BatchResult result;
+    if (count == 0) {
+        return result;
+    }
+
+    SqliteTransaction transaction(db_, statements_->mutex());
+    for (std::size_t i = 0; i < count; ++i) {
+        stmt.reset();
+        bind(stmt, i);
+        int rc = sqlite3_step(stmt);
+        if (rc == SQLITE_DONE) {
+            ++result.written;
+            if (written) {
+                written(i);
+            }
+            continue;
+        }
+
+        std::ostringstream oss;
+        oss << "SQLite error (" << context << ", row " << i << "): " << sqlite3_errmsg(db_);
+        if (mode == BatchMode::AllOrNothing || sqlite3_get_autocommit(db_)) {
+            // Either the caller asked for atomicity or SQLite already aborted the transaction
+            throw std::runtime_error(oss.str());
+        }
+        result.errors.emplace_back(i, oss.str());
+    }
+    transaction.commit();
+    return result;
+}
+
+void DatabaseManager::logAction(const std::string& action_type, const std::string& task_id, const std::string& message) {
+    LogEntry entry{action_type, task_id, message, QDateTime::currentSecsSinceEpoch()};
+    if (log_writer_) {
+        log_writer_->enqueue(std::move(entry));
+        return;
+    }
+    writeLogBatch(std::span<const LogEntry>(&entry, 1));
+}
+
+void DatabaseManager::writeLogBatch(std::span<const LogEntry> entries) {
+    CachedStatement stmt = cachedStatement(Query::InsertLog,
+        "INSERT INTO logs (timestamp, action_type, task_id, message) "
+        "VALUES (datetime(?, 'unixepoch'), ?, ?, ?);");
+
+    SqliteTransaction transaction(db_, statements_->mutex());
+    for (const auto& entry : entries) {
+        stmt.reset();
+        sqlite3_bind_int64(stmt, 1, entry.timestamp);
+        bindText(stmt, 2, entry.action_type);
+        bindText(stmt, 3, entry.task_id);
+        bindText(stmt, 4, entry.message);
+
+        int rc = sqlite3_step(stmt);
+        if (rc != SQLITE_DONE) {
+            throwOnError(rc, "execute INSERT log");
+        }
+    }
+    transaction.commit();
+}
+
+void DatabaseManager::flushLogs() {
+    if (log_writer_) {
+        log_writer_->flush();
+    }
+}
+
+AuditLogStats DatabaseManager::logStats() const {
+    return log_writer_ ? log_writer_->stats() : AuditLogStats();
 }
 
 void DatabaseManager::bindTaskParameters(sqlite3_stmt* stmt, const Task& task) {
-    sqlite3_bind_text(stmt, 1, task.get_id().c_str(), -1, SQLITE_TRANSIENT);
+    // The task outlives the statement lease, so its buffers are bound in place
+    bindText(stmt, 1, task.get_id_view());
     sqlite3_bind_int(stmt, 2, static_cast<int>(task.get_type()));
     sqlite3_bind_int(stmt, 3, static_cast<int>(task.get_status()));
-    sqlite3_bind_text(stmt, 4, task.get_title().c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 5, task.get_description().c_str(), -1, SQLITE_TRANSIENT);
+    bindText(stmt, 4, task.get_title_view());
+    bindText(stmt, 5, task.get_description_view());
     // created_at
     sqlite3_bind_int64(stmt, 6, QDateTime::currentSecsSinceEpoch());
     // deadline
@@ -215,19 +706,32 @@ void DatabaseManager::bindTaskParameters(sqlite3_stmt* stmt, const Task& task) {
     } else {
         sqlite3_bind_null(stmt, 11);
     }
-    // next_execution (пока не используется)
-    sqlite3_bind_null(stmt, 12);
+    // next_execution: what claimDueTasks() and the due-time queries look at
+    if (auto next = task.next_execution_time(std::chrono::system_clock::now())) {
+        sqlite3_bind_int64(stmt, 12, std::chrono::system_clock::to_time_t(*next));
+    } else {
+        sqlite3_bind_null(stmt, 12);
+    }
+    // owner_chat_id (NULL for tasks created in the GUI)
+    if (!task.get_owner_chat_id_view().empty()) {
+        bindText(stmt, 13, task.get_owner_chat_id_view());
+    } else {
+        sqlite3_bind_null(stmt, 13);
+    }
 }
 
-Task DatabaseManager::mapTaskFromRow(sqlite3_stmt* stmt) {
-    Task task;
-
-    task.set_id(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+void DatabaseManager::mapTaskFromRow(sqlite3_stmt* stmt, Task& task) {
+    // Every field is overwritten, so the same Task can be reused for the next row
+    task.assign_id(columnText(stmt, 0));
     task.set_type(static_cast<Task::Type>(sqlite3_column_int(stmt, 1)));
     task.set_status(static_cast<Task::Status>(sqlite3_column_int(stmt, 2)));
-    task.set_title(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)));
-    if (sqlite3_column_type(stmt, 4) != SQLITE_NULL) {
-        task.set_description(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4)));
+    task.assign_title(columnText(stmt, 3));
+    task.assign_description(columnText(stmt, 4));
+    // deadline
+    if (sqlite3_column_type(stmt, 6) != SQLITE_NULL) {
+        task.restore_deadline(QDateTime::fromSecsSinceEpoch(sqlite3_column_int64(stmt, 6)));
+    } else {
+        task.restore_deadline(QDateTime());
     }
     // interval
     int seconds = sqlite3_column_int(stmt, 8);
@@ -236,130 +740,508 @@ Task DatabaseManager::mapTaskFromRow(sqlite3_stmt* stmt) {
     if (sqlite3_column_type(stmt, 9) != SQLITE_NULL) {
         qint64 end_date = sqlite3_column_int64(stmt, 9);
         task.set_end_date(QDateTime::fromSecsSinceEpoch(end_date));
+    } else {
+        task.set_end_date(QDateTime());
     }
     // last_execution
+    task.clear_executions();
     if (sqlite3_column_type(stmt, 10) != SQLITE_NULL) {
         time_t last_exec = sqlite3_column_int64(stmt, 10);
         task.mark_execution(std::chrono::system_clock::from_time_t(last_exec));
     }
-    
-    return task;
+    // next_execution
+    if (sqlite3_column_type(stmt, 11) != SQLITE_NULL) {
+        task.restore_next_execution(std::chrono::system_clock::from_time_t(sqlite3_column_int64(stmt, 11)));
+    }
+    // owner_chat_id
+    task.assign_owner_chat_id(columnText(stmt, 12));
+}
+
+std::size_t DatabaseManager::addTaskObserver(TaskObserver observer) {
+    std::lock_guard<std::mutex> lock(observers_mutex_);
+    observers_.emplace_back(next_observer_, std::move(observer));
+    return next_observer_++;
+}
+
+void DatabaseManager::removeTaskObserver(std::size_t handle) {
+    std::lock_guard<std::mutex> lock(observers_mutex_);
+    std::erase_if(observers_, [handle](const auto& entry) { return entry.first == handle; });
+}
+
+ScopedTaskObserver::ScopedTaskObserver(DatabaseManager& db, DatabaseManager::TaskObserver observer)
+    : db_(&db), handle_(db.addTaskObserver(std::move(observer))) {}
+
+ScopedTaskObserver::~ScopedTaskObserver() {
+    reset();
+}
+
+ScopedTaskObserver::ScopedTaskObserver(ScopedTaskObserver&& other) noexcept
+    : db_(std::exchange(other.db_, nullptr)), handle_(other.handle_) {}
+
+ScopedTaskObserver& ScopedTaskObserver::operator=(ScopedTaskObserver&& other) noexcept {
+    if (this != &other) {
+        reset();
+        db_ = std::exchange(other.db_, nullptr);
+        handle_ = other.handle_;
+    }
+    return *this;
+}
+
+void ScopedTaskObserver::reset() noexcept {
+    if (db_) {
+        db_->removeTaskObserver(handle_);
+        db_ = nullptr;
+    }
+}
+
+void DatabaseManager::notifyTaskObservers(TaskChange change, std::string_view id, const Task* task) {
+    std::lock_guard<std::mutex> lock(observers_mutex_);
+    for (const auto& [handle, observer] : observers_) {
+        try {
+            observer(change, id, task);
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] Task observer failed: " << e.what() << std::endl;
+        }
+    }
 }
 
 void DatabaseManager::saveTemplate(const TaskTemplate& tmpl) {
-    const std::string sql = 
+    CachedStatement stmt = cachedStatement(Query::InsertTemplate,
         "INSERT INTO templates (title, description, interval_hours) "
-        "VALUES (?, ?, ?);";
-    
-    sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-    throwOnError(rc, "prepare INSERT template");
+        "VALUES (?, ?, ?);");
 
-    sqlite3_bind_text(stmt, 1, tmpl.get_title().c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, tmpl.get_description().c_str(), -1, SQLITE_TRANSIENT);
+    // The getters return copies: keep them alive until the step, as the text is bound without copying
+    const std::string title = tmpl.get_title();
+    const std::string description = tmpl.get_description();
+    bindText(stmt, 1, title);
+    bindText(stmt, 2, description);
     sqlite3_bind_int(stmt, 3, tmpl.get_interval_hours());
 
-    rc = sqlite3_step(stmt);
+    int rc = sqlite3_step(stmt);
     if (rc != SQLITE_DONE) throwOnError(rc, "execute INSERT template");
-    sqlite3_finalize(stmt);
 }
 
 std::vector<std::string> DatabaseManager::getAllChatIds() const {
+    return chats_.snapshot();
+}
+
+bool DatabaseManager::isChatRegistered(std::string_view chat_id) const {
+    return chats_.contains(chat_id);
+}
+
+void DatabaseManager::loadChatIds() {
     std::vector<std::string> chat_ids;
-    const std::string sql = "SELECT chat_id FROM telegram_chats;";
-    sqlite3_stmt* stmt = nullptr;
-    
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-    throwOnError(rc, "prepare SELECT chat_ids");
-    
-    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
-        chat_ids.push_back(
-            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0))
-        );
+    {
+        CachedStatement stmt = cachedStatement(Query::SelectChatIds, "SELECT chat_id FROM telegram_chats ORDER BY rowid;");
+
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            chat_ids.emplace_back(
+                reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)),
+                static_cast<size_t>(sqlite3_column_bytes(stmt, 0))
+            );
+        }
+        throwOnError(rc, "execute SELECT chat_ids");
     }
-    sqlite3_finalize(stmt);
-    return chat_ids;
+    // Writes take the registry lock before the writer lock; do not hold the lease here
+    chats_.assign(std::move(chat_ids));
 }
 
 std::vector<Task> DatabaseManager::getAllTasks(const std::string& table_name) {
+    CachedStatement stmt = readStatement(Query::SelectAllTasks, table_name, "SELECT * FROM ", ";");
+    return collectTasks(stmt, "execute SELECT all tasks");
+}
+
+std::vector<Task> DatabaseManager::getTasksDueBefore(PeriodicTracker::TimePoint time, OwnerFilter owner) {
     std::vector<Task> tasks;
-    const std::string sql = "SELECT * FROM " + table_name + ";";
-    
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-    throwOnError(rc, "prepare SELECT all tasks");
-    
-    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
-        tasks.push_back(mapTaskFromRow(stmt));
+    forEachTaskDueBefore(time, [&tasks](const Task& task) {
+        tasks.push_back(task);
+        return true;
+    }, owner);
+    return tasks;
+}
+
+std::vector<Task> DatabaseManager::getTasksByStatus(Task::Status status, OwnerFilter owner) {
+    CachedStatement stmt = owner
+        ? readStatement(Query::SelectByStatusForOwner, "SELECT * FROM tasks WHERE owner_chat_id = ?2 AND status = ?1;")
+        : readStatement(Query::SelectByStatus, "SELECT * FROM tasks WHERE status = ?1;");
+    sqlite3_bind_int(stmt, 1, static_cast<int>(status));
+    if (owner) {
+        bindText(stmt, 2, *owner);
     }
-    
-    sqlite3_finalize(stmt);
+    return collectTasks(stmt, "execute SELECT tasks by status");
+}
+
+std::vector<Task> DatabaseManager::getUpcoming(std::size_t limit, PeriodicTracker::TimePoint from, OwnerFilter owner) {
+    // Unscoped: each branch walks its own index in order and stops after `limit` rows; the outer sort merges them.
+    // Scoped: one owner's rows are few, so they are read through the owner index and sorted directly
+    // (the unary + keeps the planner from switching to the global deadline/next_execution indexes).
+    CachedStatement stmt = owner
+        ? readStatement(Query::SelectUpcomingForOwner,
+            "SELECT *, CASE WHEN deadline >= ?1 THEN deadline ELSE next_execution END AS due_at FROM tasks "
+            "WHERE owner_chat_id = ?3 AND status = 0 "
+            "AND (+deadline >= ?1 OR (+next_execution >= ?1 AND (deadline IS NULL OR deadline < ?1))) "
+            "ORDER BY due_at LIMIT ?2;")
+        : readStatement(Query::SelectUpcoming,
+            "SELECT * FROM ("
+            "  SELECT *, deadline AS due_at FROM tasks "
+            "  WHERE status = 0 AND deadline >= ?1 ORDER BY deadline LIMIT ?2) "
+            "UNION ALL "
+            "SELECT * FROM ("
+            "  SELECT *, next_execution AS due_at FROM tasks "
+            "  WHERE status = 0 AND next_execution >= ?1 AND (deadline IS NULL OR deadline < ?1) "
+            "  ORDER BY next_execution LIMIT ?2) "
+            "ORDER BY due_at LIMIT ?2;");
+    sqlite3_bind_int64(stmt, 1, std::chrono::system_clock::to_time_t(from));
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(limit));
+    if (owner) {
+        bindText(stmt, 3, *owner);
+    }
+    return collectTasks(stmt, "execute SELECT upcoming tasks");
+}
+
+std::size_t DatabaseManager::forEachTask(const TaskVisitor& visitor, const std::string& table_name) {
+    CachedStatement stmt = readStatement(Query::SelectAllTasks, table_name, "SELECT * FROM ", ";");
+    return visitTasks(stmt, visitor, "execute SELECT all tasks");
+}
+
+std::vector<Task> DatabaseManager::getTasksByOwner(std::string_view owner_chat_id) {
+    std::vector<Task> tasks;
+    forEachTaskOfOwner(owner_chat_id, [&tasks](const Task& task) {
+        tasks.push_back(task);
+        return true;
+    });
     return tasks;
 }
 
-std::pair<int, int> DatabaseManager::getTaskStats() {
-    int completed = 0, pending = 0;
-    const std::string sql_completed = "SELECT COUNT(*) FROM tasks WHERE is_completed = 1";
-    const std::string sql_pending = "SELECT COUNT(*) FROM tasks WHERE is_completed = 0";
+std::size_t DatabaseManager::forEachTaskOfOwner(std::string_view owner_chat_id, const TaskVisitor& visitor) {
+    CachedStatement stmt = readStatement(Query::SelectByOwner, "SELECT * FROM tasks WHERE owner_chat_id = ?;");
+    bindText(stmt, 1, owner_chat_id);
+    return visitTasks(stmt, visitor, "execute SELECT tasks by owner");
+}
 
-    sqlite3_stmt* stmt;
-    
-    sqlite3_prepare_v2(db_, sql_completed.c_str(), -1, &stmt, nullptr);
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        completed = sqlite3_column_int(stmt, 0);
+std::size_t DatabaseManager::forEachTaskDueBefore(PeriodicTracker::TimePoint time, const TaskVisitor& visitor, OwnerFilter owner) {
+    // When scoped, the unary + keeps the planner on the owner index instead of the global due-time indexes
+    CachedStatement stmt = owner
+        ? readStatement(Query::SelectDueBeforeForOwner,
+            "SELECT * FROM tasks WHERE owner_chat_id = ?2 AND status = 0 "
+            "AND (+deadline <= ?1 OR +next_execution <= ?1);")
+        : readStatement(Query::SelectDueBefore,
+            "SELECT * FROM tasks WHERE status = 0 AND deadline <= ?1 "
+            "UNION ALL "
+            "SELECT * FROM tasks WHERE status = 0 AND next_execution <= ?1 "
+            "AND (deadline IS NULL OR deadline > ?1);");
+    sqlite3_bind_int64(stmt, 1, std::chrono::system_clock::to_time_t(time));
+    if (owner) {
+        bindText(stmt, 2, *owner);
     }
-    sqlite3_finalize(stmt);
+    return visitTasks(stmt, visitor, "execute SELECT due tasks");
+}
 
-    sqlite3_prepare_v2(db_, sql_pending.c_str(), -1, &stmt, nullptr);
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        pending = sqlite3_column_int(stmt, 0);
+std::vector<Task> DatabaseManager::claimDueTasks(PeriodicTracker::TimePoint now, std::size_t limit) {
+    // The writer lock spans the read and the write, so no other write claims the same rows
+    std::unique_lock<std::recursive_mutex> lock(statements_->mutex());
+    std::vector<Task> claimed;
+    {
+        CachedStatement stmt = cachedStatement(Query::SelectDueExecutions,
+            "SELECT * FROM tasks WHERE status = 0 AND next_execution <= ?1 ORDER BY next_execution LIMIT ?2;");
+        sqlite3_bind_int64(stmt, 1, std::chrono::system_clock::to_time_t(now));
+        sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(limit));
+        claimed = collectTasks(stmt, "execute SELECT due executions");
     }
-    sqlite3_finalize(stmt);
+    claimSelected(claimed, now);
+    return claimed;
+}
+
+std::vector<Task> DatabaseManager::getDueTasks(PeriodicTracker::TimePoint now, std::size_t limit) {
+    CachedStatement stmt = readStatement(Query::SelectDueExecutions,
+        "SELECT * FROM tasks WHERE status = 0 AND next_execution <= ?1 ORDER BY next_execution LIMIT ?2;");
+    sqlite3_bind_int64(stmt, 1, std::chrono::system_clock::to_time_t(now));
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(limit));
+    return collectTasks(stmt, "execute SELECT due executions");
+}
+
+std::optional<Task> DatabaseManager::claimTask(std::string_view id, PeriodicTracker::TimePoint now) {
+    std::unique_lock<std::recursive_mutex> lock(statements_->mutex());
+    std::vector<Task> claimed;
+    {
+        CachedStatement stmt = cachedStatement(Query::SelectDueById,
+            "SELECT * FROM tasks WHERE id = ?1 AND status = 0 AND next_execution <= ?2;");
+        bindText(stmt, 1, id);
+        sqlite3_bind_int64(stmt, 2, std::chrono::system_clock::to_time_t(now));
+        claimed = collectTasks(stmt, "execute SELECT due task");
+    }
+    if (claimed.empty()) {
+        return std::nullopt;
+    }
+    claimSelected(claimed, now);
+    return std::move(claimed.front());
+}
+
+void DatabaseManager::claimSelected(std::vector<Task>& tasks, PeriodicTracker::TimePoint now) {
+    for (auto& task : tasks) {
+        advanceSchedule(task, now, task.next_execution_time(now));
+    }
+    updateTasks(tasks);
+}
+
+void DatabaseManager::advanceSchedule(Task& task, PeriodicTracker::TimePoint when, std::optional<PeriodicTracker::TimePoint> due) {
+    // The tracker is refilled from the stored history, so the cadence it learns carries over
+    auto history = storedExecutions(task.get_id_view(), PeriodicTracker::kHistory);
+    if (!history.empty()) {
+        task.clear_executions();
+        for (auto execution : history) {
+            task.mark_execution(execution);
+        }
+    }
+    task.mark_execution(when);
+
+    // Until the tracker holds a full window the configured interval rules; one late run
+    // would otherwise become the whole cadence. The learned period stays within a factor
+    // of two of the configured one.
+    const auto interval = std::chrono::duration_cast<PeriodicTracker::Clock::duration>(task.get_interval());
+    auto next = due ? *due : when + interval;
+    const auto& tracker = task.get_tracker();
+    if (tracker.execution_count() > PeriodicTracker::kHistory && interval.count() > 0) {
+        next = when + std::clamp<PeriodicTracker::Clock::duration>(tracker.get_interval(), interval / 2, interval * 2);
+    }
+    // Periods already missed are skipped
+    if (interval.count() > 0 && next <= when) {
+        next += ((when - next) / interval + 1) * interval;
+    }
+    task.restore_next_execution(next);
+}
+
+std::vector<DatabaseManager::PurgedTask> DatabaseManager::purgeCompletedTasks() {
+    // One statement whatever the count; the delete trigger drops their scheduled events
+    CachedStatement stmt = cachedStatement(Query::PurgeCompleted,
+        "DELETE FROM tasks WHERE status = 1 AND type <> 2 RETURNING id, type, title, owner_chat_id;");
+    std::vector<PurgedTask> purged;
+    TaskStatistics::Delta delta;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        purged.push_back({std::string(columnText(stmt, 0)), std::string(columnText(stmt, 2)),
+                          std::string(columnText(stmt, 3))});
+        delta.remove(Task::Status::Completed, static_cast<Task::Type>(sqlite3_column_int(stmt, 1)));
+    }
+    throwOnError(rc, "execute DELETE completed tasks");
+    stats_.apply(delta);
+    for (const auto& task : purged) {
+        notifyTaskObservers(TaskChange::Deleted, task.id, nullptr);
+    }
+    return purged;
+}
+
+std::vector<std::chrono::seconds> DatabaseManager::deadlineLeads() const {
+    CachedStatement stmt = readStatement(Query::SelectLeads, "SELECT lead_seconds FROM deadline_leads ORDER BY lead_seconds DESC;");
+    std::vector<std::chrono::seconds> leads;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        leads.emplace_back(sqlite3_column_int64(stmt, 0));
+    }
+    throwOnError(rc, "execute SELECT deadline leads", sqlite3_db_handle(stmt));
+    return leads;
+}
+
+void DatabaseManager::setDeadlineLeads(std::span<const std::chrono::seconds> leads) {
+    std::vector<std::chrono::seconds> wanted;
+    for (auto lead : leads) {
+        if (lead.count() <= 0) {
+            throw std::invalid_argument("Deadline lead must be positive");
+        }
+        wanted.push_back(lead);
+    }
+    std::sort(wanted.begin(), wanted.end(), std::greater<>());
+    wanted.erase(std::unique(wanted.begin(), wanted.end()), wanted.end());
+
+    SqliteTransaction transaction(db_, statements_->mutex());
+    if (deadlineLeads() == wanted) {
+        return;
+    }
+    executeQuery("DELETE FROM deadline_leads;");
+    {
+        CachedStatement stmt = cachedStatement(Query::InsertLead, "INSERT INTO deadline_leads VALUES (?);");
+        for (auto lead : wanted) {
+            stmt.reset();
+            sqlite3_bind_int64(stmt, 1, lead.count());
+            int rc = sqlite3_step(stmt);
+            if (rc != SQLITE_DONE) throwOnError(rc, "execute INSERT deadline lead");
+        }
+    }
+    // Events already fired stay fired; the pending ones are recomputed for the new leads
+    executeQuery("DELETE FROM scheduled_events WHERE fire_at > CAST(strftime('%s', 'now') AS INTEGER);");
+    executeQuery("INSERT OR IGNORE INTO scheduled_events (task_id, lead_seconds, fire_at) "
+                 "SELECT t.id, l.lead_seconds, t.deadline - l.lead_seconds FROM tasks t, deadline_leads l "
+                 "WHERE t.type = 1 AND t.status = 0 AND t.deadline IS NOT NULL "
+                 "AND t.deadline - l.lead_seconds > CAST(strftime('%s', 'now') AS INTEGER);");
+    transaction.commit();
+}
+
+std::vector<DatabaseManager::DeadlineEvent> DatabaseManager::claimDueEvents(PeriodicTracker::TimePoint now, std::size_t limit) {
+    SqliteTransaction transaction(db_, statements_->mutex());
+    const auto now_seconds = std::chrono::system_clock::to_time_t(now);
+    std::vector<DeadlineEvent> events;
+    {
+        // Same order and limit as the DELETE below, so both see the same rows
+        CachedStatement stmt = cachedStatement(Query::SelectDueEvents,
+            "SELECT e.task_id, e.lead_seconds, t.title, t.owner_chat_id, t.deadline "
+            "FROM scheduled_events e JOIN tasks t ON t.id = e.task_id "
+            "WHERE e.fire_at <= ?1 ORDER BY e.fire_at, e.rowid LIMIT ?2;");
+        sqlite3_bind_int64(stmt, 1, now_seconds);
+        sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(limit));
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            DeadlineEvent event;
+            event.task_id = columnText(stmt, 0);
+            event.lead = std::chrono::seconds(sqlite3_column_int64(stmt, 1));
+            event.title = columnText(stmt, 2);
+            event.owner_chat_id = columnText(stmt, 3);
+            event.deadline = std::chrono::system_clock::from_time_t(sqlite3_column_int64(stmt, 4));
+            events.push_back(std::move(event));
+        }
+        throwOnError(rc, "execute SELECT due events");
+    }
+    {
+        CachedStatement stmt = cachedStatement(Query::DeleteDueEvents,
+            "DELETE FROM scheduled_events WHERE rowid IN ("
+            "SELECT rowid FROM scheduled_events WHERE fire_at <= ?1 ORDER BY fire_at, rowid LIMIT ?2);");
+        sqlite3_bind_int64(stmt, 1, now_seconds);
+        sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(limit));
+        int rc = sqlite3_step(stmt);
+        if (rc != SQLITE_DONE) throwOnError(rc, "execute DELETE due events");
+    }
+    transaction.commit();
+    return events;
+}
+
+std::optional<PeriodicTracker::TimePoint> DatabaseManager::nextEventTime() const {
+    CachedStatement stmt = readStatement(Query::NextEventTime, "SELECT MIN(fire_at) FROM scheduled_events;");
+    if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL) {
+        return std::chrono::system_clock::from_time_t(sqlite3_column_int64(stmt, 0));
+    }
+    return std::nullopt;
+}
+
+std::vector<PeriodicTracker::TimePoint> DatabaseManager::recentExecutions(std::string_view task_id, std::size_t limit) const {
+    CachedStatement stmt = readStatement(Query::SelectHistory, "SELECT deltas FROM execution_history WHERE task_id = ?;");
+    return decodeExecutions(stmt, task_id, limit);
+}
+
+std::vector<PeriodicTracker::TimePoint> DatabaseManager::storedExecutions(std::string_view task_id, std::size_t limit) {
+    CachedStatement stmt = cachedStatement(Query::SelectHistory, "SELECT deltas FROM execution_history WHERE task_id = ?;");
+    return decodeExecutions(stmt, task_id, limit);
+}
+
+std::vector<PeriodicTracker::TimePoint> DatabaseManager::decodeExecutions(CachedStatement& stmt, std::string_view task_id, std::size_t limit) const {
+    bindText(stmt, 1, task_id);
+    std::vector<PeriodicTracker::TimePoint> executions;
+    int rc = sqlite3_step(stmt);
+    if (rc != SQLITE_ROW) {
+        throwOnError(rc, "execute SELECT execution history", sqlite3_db_handle(stmt));
+        return executions;
+    }
+    const auto* data = static_cast<const std::uint8_t*>(sqlite3_column_blob(stmt, 0));
+    std::span<const std::uint8_t> blob(data, static_cast<std::size_t>(sqlite3_column_bytes(stmt, 0)));
+    for (std::int64_t seconds : ExecutionHistory::decodeLast(blob, limit)) {
+        executions.push_back(std::chrono::system_clock::from_time_t(static_cast<std::time_t>(seconds)));
+    }
+    return executions;
+}
+
+std::size_t DatabaseManager::executionCount(std::string_view task_id) const {
+    CachedStatement stmt = readStatement(Query::CountHistory, "SELECT executions FROM execution_history WHERE task_id = ?;");
+    bindText(stmt, 1, task_id);
+    int rc = sqlite3_step(stmt);
+    if (rc != SQLITE_ROW) {
+        throwOnError(rc, "execute SELECT execution count", sqlite3_db_handle(stmt));
+        return 0;
+    }
+    return static_cast<std::size_t>(sqlite3_column_int64(stmt, 0));
+}
+
+std::size_t DatabaseManager::visitTasks(sqlite3_stmt* stmt, const TaskVisitor& visitor, const char* context) {
+    std::size_t visited = 0;
+    Task task;  // reused for every row: its strings keep their capacity
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        ++visited;
+        mapTaskFromRow(stmt, task);
+        if (!visitor(task)) {
+            return visited;
+        }
+    }
+    throwOnError(rc, context, sqlite3_db_handle(stmt));
+    return visited;
+}
+
+std::vector<Task> DatabaseManager::collectTasks(sqlite3_stmt* stmt, const char* context) {
+    std::vector<Task> tasks;
+    visitTasks(stmt, [&tasks](const Task& task) {
+        tasks.push_back(task);
+        return true;
+    }, context);
+    return tasks;
+}
+
+std::pair<int, int> DatabaseManager::getTaskStats() const noexcept {
+    return {stats_.completed(), stats_.pending()};
+}
+
+const TaskStatistics& DatabaseManager::statistics() const noexcept {
+    return stats_;
+}
 
-    return {completed, pending};
+void DatabaseManager::refreshStatistics() {
+    // Runs on the writer with its lock held, so no write changes the counters while they are rebuilt
+    CachedStatement stmt = cachedStatement(Query::CountByStatusType,
+        "SELECT status, type, COUNT(*) FROM tasks GROUP BY status, type;");
+
+    stats_.clear();
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        int status = sqlite3_column_int(stmt, 0);
+        int type = sqlite3_column_int(stmt, 1);
+        if (status < 0 || status >= TaskStatistics::kStatuses || type < 0 || type >= TaskStatistics::kTypes) {
+            continue;  // rows with out-of-range codes are not counted
+        }
+        stats_.set(static_cast<Task::Status>(status), static_cast<Task::Type>(type), sqlite3_column_int(stmt, 2));
+    }
+    throwOnError(rc, "execute SELECT task statistics");
 }
 
 std::vector<TaskTemplate> DatabaseManager::getAllTemplates() {
     std::vector<TaskTemplate> templates;
-    const std::string sql = "SELECT title, description, interval_hours FROM templates;";
-    sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-    throwOnError(rc, "prepare SELECT templates");
-    
+    CachedStatement stmt = readStatement(Query::SelectTemplates,
+        "SELECT title, description, interval_hours FROM templates;");
+
+    int rc;
     while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
         std::string title = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
         std::string desc = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
         int interval = sqlite3_column_int(stmt, 2);
         templates.emplace_back(title, desc, interval);
     }
-    
-    sqlite3_finalize(stmt);
+    throwOnError(rc, "execute SELECT templates", sqlite3_db_handle(stmt));
     return templates;
 }
 
 void DatabaseManager::saveChatId(const std::string& chat_id) {
     try {
-        executeQuery("CREATE TABLE IF NOT EXISTS telegram_chats (chat_id TEXT PRIMARY KEY);");
-        
-        const std::string sql = "INSERT OR IGNORE INTO telegram_chats (chat_id) VALUES (?);";
-        sqlite3_stmt* stmt = nullptr;
-        
-        int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-        if (rc != SQLITE_OK) {
-            throw std::runtime_error("Ошибка подготовки запроса: " + std::string(sqlite3_errmsg(db_)));
-        }
-        sqlite3_bind_text(stmt, 1, chat_id.c_str(), -1, SQLITE_TRANSIENT);
-        rc = sqlite3_step(stmt);
-        
-        sqlite3_finalize(stmt);
-        
-        if (rc != SQLITE_DONE) {
-            if (rc == SQLITE_CONSTRAINT) {
-                std::cout << "[INFO] Chat ID " << chat_id << " уже существует." << std::endl;
-            } else {
-                throw std::runtime_error("Ошибка выполнения запроса: " + std::string(sqlite3_errmsg(db_)));
+        // The registry lock spans the INSERT, so a concurrent delete cannot leave the two apart
+        chats_.insert(chat_id, [&]() {
+            CachedStatement stmt = cachedStatement(Query::InsertChatId,
+                "INSERT OR IGNORE INTO telegram_chats (chat_id) VALUES (?);");
+            bindText(stmt, 1, chat_id);
+            int rc = sqlite3_step(stmt);
+
+            if (rc != SQLITE_DONE) {
+                if (rc == SQLITE_CONSTRAINT) {
+                    std::cout << "[INFO] Chat ID " << chat_id << " уже существует." << std::endl;
+                } else {
+                    throw std::runtime_error("Ошибка выполнения запроса: " + std::string(sqlite3_errmsg(db_)));
+                }
             }
-        }
+        });
     } catch (const std::exception& e) {
         std::cerr << "[ERROR] DatabaseManager::saveChatId: " << e.what() << std::endl;
         throw;
@@ -367,58 +1249,50 @@ void DatabaseManager::saveChatId(const std::string& chat_id) {
 }
 
 void DatabaseManager::unlinkAllAccounts() {
-    executeQuery("DELETE FROM telegram_chats;");
+    chats_.clear([this]() { executeQuery("DELETE FROM telegram_chats;"); });
 }
 
 void DatabaseManager::deleteAllChatIds() {
-    executeQuery("DELETE FROM telegram_chats;");
+    chats_.clear([this]() { executeQuery("DELETE FROM telegram_chats;"); });
 }
 
 bool DatabaseManager::tableExists(const std::string& tableName) {
-    std::string sql = "SELECT count(*) FROM sqlite_master WHERE type='table' AND name=?";
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        throw std::runtime_error("Ошибка проверки существования таблицы.");
-    }
-    sqlite3_bind_text(stmt, 1, tableName.c_str(), -1, SQLITE_TRANSIENT);
-    rc = sqlite3_step(stmt);
-    bool exists = (rc == SQLITE_ROW && sqlite3_column_int(stmt, 0) > 0);
-    sqlite3_finalize(stmt);
-    return exists;
+    CachedStatement stmt = cachedStatement(Query::TableExists,
+        "SELECT count(*) FROM sqlite_master WHERE type='table' AND name=?");
+    bindText(stmt, 1, tableName);
+    int rc = sqlite3_step(stmt);
+    return (rc == SQLITE_ROW && sqlite3_column_int(stmt, 0) > 0);
 }
 
-void DatabaseManager::executeTaskQuery(const std::string& sql, const Task& task) {
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-    throwOnError(rc, "prepare query");
-    
+void DatabaseManager::executeTaskStatement(sqlite3_stmt* stmt, const Task& task) {
     bindTaskParameters(stmt, task);
-    
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    int rc = sqlite3_step(stmt);
     throwOnError(rc, "execute query");
 }
 
-Task DatabaseManager::getTaskById(const std::string& id) {
-    const std::string sql = "SELECT * FROM tasks WHERE id = ?;";
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-    throwOnError(rc, "prepare SELECT by id");
-    
-    sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_TRANSIENT);
-    
+Task DatabaseManager::getTaskById(const std::string& id, OwnerFilter owner) {
+    CachedStatement stmt = owner
+        ? readStatement(Query::SelectTaskByIdForOwner,
+            "SELECT * FROM tasks WHERE id = ?1 AND (owner_chat_id = ?2 OR owner_chat_id IS NULL);")
+        : readStatement(Query::SelectTaskById, "tasks", "SELECT * FROM ", " WHERE id = ?;");
+    bindText(stmt, 1, id);
+    if (owner) {
+        bindText(stmt, 2, *owner);
+    }
+
     if (sqlite3_step(stmt) == SQLITE_ROW) {
-        Task task = mapTaskFromRow(stmt);
-        sqlite3_finalize(stmt);
+        Task task;
+        mapTaskFromRow(stmt, task);
         return task;
     }
-    
-    sqlite3_finalize(stmt);
+
     throw std::runtime_error("Task not found");
 }
 
-std::string DatabaseManager::getFirstChatId() const {
-    auto chatIds = getAllChatIds();
-    return chatIds.empty() ? "" : chatIds[0];
+int DatabaseManager::schemaVersion() const {
+    return SchemaMigrator(db_, statements_->mutex()).current_version();
 }
+
+std::string DatabaseManager::getFirstChatId() const {
+    return chats_.first();
+}
\ No newline at end of file
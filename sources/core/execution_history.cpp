@@ -0,0 +1,73 @@
+#include "execution_history.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::uint8_t kContinuation = 0x80;
+
+std::uint64_t zigzag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+} // namespace
+
+void ExecutionHistory::append(Blob& blob, std::int64_t previous, std::int64_t timestamp) {
+    // Wrapping subtraction: the decoder adds the delta back the same way
+    std::uint64_t value = zigzag(static_cast<std::int64_t>(
+        static_cast<std::uint64_t>(timestamp) - static_cast<std::uint64_t>(previous)));
+    while (value >= kContinuation) {
+        blob.push_back(static_cast<std::uint8_t>(value) | kContinuation);
+        value >>= 7;
+    }
+    blob.push_back(static_cast<std::uint8_t>(value));
+}
+
+std::vector<std::int64_t> ExecutionHistory::decodeLast(std::span<const std::uint8_t> blob, std::size_t limit) {
+    std::vector<std::int64_t> ring;
+    if (limit == 0) {
+        return ring;
+    }
+    ring.reserve(std::min(limit, count(blob)));
+
+    std::size_t next = 0;  ///< Slot of the oldest kept execution once the ring is full
+    std::uint64_t timestamp = 0;
+    std::uint64_t value = 0;
+    int shift = 0;
+    for (std::uint8_t byte : blob) {
+        if (shift >= 64) {
+            throw std::runtime_error("Execution history varint is too long");
+        }
+        value |= static_cast<std::uint64_t>(byte & ~kContinuation) << shift;
+        if (byte & kContinuation) {
+            shift += 7;
+            continue;
+        }
+        timestamp += static_cast<std::uint64_t>(unzigzag(value));
+        if (ring.size() < limit) {
+            ring.push_back(static_cast<std::int64_t>(timestamp));
+        } else {
+            ring[next] = static_cast<std::int64_t>(timestamp);
+            next = (next + 1) % limit;
+        }
+        value = 0;
+        shift = 0;
+    }
+    if (shift != 0) {
+        throw std::runtime_error("Execution history ends in the middle of a varint");
+    }
+    std::rotate(ring.begin(), ring.begin() + static_cast<std::ptrdiff_t>(next), ring.end());
+    return ring;
+}
+
+std::size_t ExecutionHistory::count(std::span<const std::uint8_t> blob) noexcept {
+    std::size_t executions = 0;
+    for (std::uint8_t byte : blob) {
+        executions += (byte & kContinuation) == 0;
+    }
+    return executions;
+}
@@ -0,0 +1,149 @@
+#include "http_request_parser.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <utility>
+
+namespace {
+
+std::string_view trimmed(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+std::string lowered(std::string_view s) {
+    std::string result(s);
+    std::transform(result.begin(), result.end(), result.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return result;
+}
+
+} // namespace
+
+std::string HttpRequest::header(const std::string& name) const {
+    auto it = headers.find(name);
+    return it != headers.end() ? it->second : std::string();
+}
+
+HttpRequestParser::HttpRequestParser(std::size_t max_body, std::size_t max_header)
+    : max_body_(max_body), max_header_(max_header) {}
+
+HttpRequestParser::Result HttpRequestParser::feed(std::string_view data) {
+    if (!error_.empty()) {
+        return Result::Error;
+    }
+    if (complete_) {
+        // The previous request has not been taken yet
+        buffer_.append(data);
+        return Result::Complete;
+    }
+    buffer_.append(data);
+    return parse();
+}
+
+HttpRequest HttpRequestParser::take() {
+    complete_ = false;
+    return std::exchange(request_, HttpRequest{});
+}
+
+const std::string& HttpRequestParser::error() const noexcept {
+    return error_;
+}
+
+HttpRequestParser::Result HttpRequestParser::parse() {
+    // The head is parsed once; later reads only wait for the rest of the body
+    if (!head_parsed_) {
+        Result result = parseHead();
+        if (result != Result::Complete) {
+            return result;
+        }
+    }
+    if (buffer_.size() < body_start_ + body_length_) {
+        return Result::NeedMore;
+    }
+    request_.body = buffer_.substr(body_start_, body_length_);
+    buffer_.erase(0, body_start_ + body_length_);
+    head_parsed_ = false;
+    scanned_ = 0;
+    complete_ = true;
+    return Result::Complete;
+}
+
+HttpRequestParser::Result HttpRequestParser::parseHead() {
+    // Resume the search where the last read ended, less what could be the start of a split "\r\n\r\n"
+    const std::size_t header_end = buffer_.find("\r\n\r\n", scanned_ > 3 ? scanned_ - 3 : 0);
+    if (header_end == std::string::npos) {
+        scanned_ = buffer_.size();
+        return buffer_.size() > max_header_ ? fail("Header too large") : Result::NeedMore;
+    }
+    if (header_end > max_header_) {
+        return fail("Header too large");
+    }
+
+    std::string_view head(buffer_.data(), header_end);
+    std::size_t line_end = head.find("\r\n");
+    std::string_view request_line = head.substr(0, line_end);
+    head = line_end == std::string_view::npos ? std::string_view() : head.substr(line_end + 2);
+
+    const std::size_t first_space = request_line.find(' ');
+    const std::size_t second_space = request_line.find(' ', first_space + 1);
+    if (first_space == std::string_view::npos || second_space == std::string_view::npos) {
+        return fail("Malformed request line");
+    }
+    const std::string_view version = request_line.substr(second_space + 1);
+    if (version != "HTTP/1.1" && version != "HTTP/1.0") {
+        return fail("Unsupported HTTP version");
+    }
+
+    HttpRequest request;
+    request.method = std::string(request_line.substr(0, first_space));
+    request.target = std::string(request_line.substr(first_space + 1, second_space - first_space - 1));
+    request.keep_alive = version == "HTTP/1.1";
+
+    while (!head.empty()) {
+        line_end = head.find("\r\n");
+        std::string_view line = head.substr(0, line_end);
+        head = line_end == std::string_view::npos ? std::string_view() : head.substr(line_end + 2);
+
+        const std::size_t colon = line.find(':');
+        if (colon == std::string_view::npos || colon == 0) {
+            return fail("Malformed header");
+        }
+        request.headers[lowered(trimmed(line.substr(0, colon)))] = std::string(trimmed(line.substr(colon + 1)));
+    }
+
+    if (!request.header("transfer-encoding").empty()) {
+        return fail("Chunked bodies are not supported");
+    }
+    const std::string connection = lowered(request.header("connection"));
+    if (connection == "close") {
+        request.keep_alive = false;
+    } else if (connection == "keep-alive") {
+        request.keep_alive = true;
+    }
+
+    std::size_t body_length = 0;
+    const std::string length = request.header("content-length");
+    if (!length.empty()) {
+        auto [end, ec] = std::from_chars(length.data(), length.data() + length.size(), body_length);
+        if (ec != std::errc() || end != length.data() + length.size()) {
+            return fail("Invalid Content-Length");
+        }
+        if (body_length > max_body_) {
+            return fail("Body too large");
+        }
+    }
+
+    request_ = std::move(request);
+    body_start_ = header_end + 4;
+    body_length_ = body_length;
+    head_parsed_ = true;
+    return Result::Complete;
+}
+
+HttpRequestParser::Result HttpRequestParser::fail(std::string message) {
+    error_ = std::move(message);
+    buffer_.clear();
+    return Result::Error;
+}
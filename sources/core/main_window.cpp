@@ -276,9 +276,7 @@ void MainWindow::onTelegramSettingsSaved() {
 void MainWindow::closeEvent(QCloseEvent* event) {
     QSettings settings;
     settings.setValue("telegramPanelVisible", telegramDock->isVisible());
-    QTimer::singleShot(0, [this]() {
-        db_.logAction("EXIT", "", "Приложение закрыто");
-    });
+    db_.logAction("EXIT", "", "Приложение закрыто");
     
     QMainWindow::closeEvent(event);
 }
@@ -428,6 +426,14 @@ void MainWindow::addTaskToList(const Task& task) {
 
     connect(taskList, &QListWidget::itemChanged, [this, item, task]() {
         bool completed = (item->checkState() == Qt::Checked);
+        if (task.is_recurring()) {
+            // A recurring task is never finished: ticking it records a run and unticks it again
+            if (completed) {
+                db_.completeTask(task.get_id_view(), std::chrono::system_clock::now());
+                formatTaskItem(item, db_.getTaskById(task.get_id()));
+            }
+            return;
+        }
         Task updated = task;
         updated.mark_completed(completed);
         
@@ -0,0 +1,143 @@
+#include "message_sender.hpp"
+#include <stdexcept>
+
+MessageSender::MessageSender(std::string bot_token, MessageSenderOptions options)
+    : bot_token_(std::move(bot_token)), options_(std::move(options))
+{
+    if (bot_token_.empty()) {
+        throw std::invalid_argument("Bot token is not configured!");
+    }
+    if (options_.max_handles == 0) {
+        options_.max_handles = 1;
+    }
+    send_url_ = method_url("sendMessage");
+    idle_.reserve(options_.max_handles);  // release() never reallocates
+
+    share_ = curl_share_init();
+    if (!share_) {
+        throw std::runtime_error("Failed to initialize CURL share handle");
+    }
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, lock_share);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, unlock_share);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+}
+
+MessageSender::~MessageSender() {
+    // Easy handles must be gone before the share they point to
+    idle_.clear();
+    if (share_) {
+        curl_share_cleanup(share_);
+    }
+}
+
+std::string MessageSender::method_url(const std::string& method) const {
+    return options_.api_base_url + "/bot" + bot_token_ + "/" + method;
+}
+
+const MessageSenderOptions& MessageSender::options() const noexcept {
+    return options_;
+}
+
+void MessageSender::configure(CURL* handle) const {
+    curl_easy_setopt(handle, CURLOPT_SHARE, share_);
+    curl_easy_setopt(handle, CURLOPT_USERAGENT, "TaskEbbBot/1.0");
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, options_.timeout_ms);
+    curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS, options_.connect_timeout_ms);
+    if (options_.http2) {
+        // HTTP/2 when ALPN agrees on it, HTTP/1.1 otherwise; wait for a connection to multiplex on
+        curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+        curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+    }
+}
+
+std::string MessageSender::encode_message(CURL* handle, const std::string& chat_id, const std::string& text) {
+    char* encoded_chat_id = curl_easy_escape(handle, chat_id.c_str(), static_cast<int>(chat_id.length()));
+    char* encoded_text = curl_easy_escape(handle, text.c_str(), static_cast<int>(text.length()));
+    std::string params;
+    if (encoded_chat_id && encoded_text) {
+        params.reserve(16 + std::char_traits<char>::length(encoded_chat_id) + std::char_traits<char>::length(encoded_text));
+        params.append("chat_id=").append(encoded_chat_id).append("&text=").append(encoded_text);
+    }
+    curl_free(encoded_chat_id);
+    curl_free(encoded_text);
+    if (params.empty()) {
+        throw std::runtime_error("Failed to encode message");
+    }
+    return params;
+}
+
+SendResult MessageSender::send(const std::string& chat_id, const std::string& text) {
+    CurlHandle curl = acquire();
+    SendResult result;
+    try {
+        const std::string params = encode_message(curl, chat_id, text);
+        curl_easy_setopt(curl, CURLOPT_URL, send_url_.c_str());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, params.c_str());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(params.size()));
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_body);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &result.body);
+
+        result.curl_code = curl_easy_perform(curl);
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &result.http_status);
+
+        // Do not leave pointers to this frame in a handle that goes back to the pool
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, nullptr);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, nullptr);
+    } catch (...) {
+        release(std::move(curl));
+        throw;
+    }
+    release(std::move(curl));
+    return result;
+}
+
+CurlHandle MessageSender::acquire() {
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    pool_cv_.wait(lock, [this] { return !idle_.empty() || created_ < options_.max_handles; });
+    if (!idle_.empty()) {
+        CurlHandle handle = std::move(idle_.back());
+        idle_.pop_back();
+        return handle;
+    }
+    ++created_;
+    lock.unlock();
+
+    try {
+        CurlHandle handle;
+        configure(handle);
+        return handle;
+    } catch (...) {
+        std::lock_guard<std::mutex> relock(pool_mutex_);
+        --created_;
+        pool_cv_.notify_one();
+        throw;
+    }
+}
+
+void MessageSender::release(CurlHandle handle) noexcept {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        idle_.push_back(std::move(handle));
+    }
+    pool_cv_.notify_one();
+}
+
+void MessageSender::lock_share(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+    static_cast<MessageSender*>(userptr)->share_locks_[data].lock();
+}
+
+void MessageSender::unlock_share(CURL*, curl_lock_data data, void* userptr) {
+    static_cast<MessageSender*>(userptr)->share_locks_[data].unlock();
+}
+
+size_t MessageSender::write_body(char* data, size_t size, size_t nmemb, void* userp) {
+    const size_t total = size * nmemb;
+    if (userp) {
+        static_cast<std::string*>(userp)->append(data, total);
+    }
+    return total;
+}
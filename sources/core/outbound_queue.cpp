@@ -0,0 +1,183 @@
+#include "outbound_queue.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Absorbs floating-point drift so a token is available exactly at ready_at()
+constexpr double kTokenEpsilon = 1e-9;
+
+} // namespace
+
+TokenBucket::TokenBucket(double rate, double capacity, Clock::time_point now) noexcept
+    : rate_(rate), capacity_(capacity), tokens_(capacity), updated_(now) {}
+
+bool TokenBucket::try_take(Clock::time_point now) noexcept {
+    refill(now);
+    if (tokens_ + kTokenEpsilon < 1.0) {
+        return false;
+    }
+    tokens_ = std::max(tokens_ - 1.0, 0.0);
+    return true;
+}
+
+TokenBucket::Clock::time_point TokenBucket::ready_at(Clock::time_point now) noexcept {
+    refill(now);
+    if (tokens_ + kTokenEpsilon >= 1.0) {
+        return now;
+    }
+    const std::chrono::duration<double> wait((1.0 - tokens_) / rate_);
+    return now + std::chrono::ceil<Clock::duration>(wait);
+}
+
+bool TokenBucket::full(Clock::time_point now) noexcept {
+    refill(now);
+    return tokens_ + kTokenEpsilon >= capacity_;
+}
+
+void TokenBucket::refill(Clock::time_point now) noexcept {
+    if (now <= updated_) {
+        return;
+    }
+    const std::chrono::duration<double> elapsed = now - updated_;
+    tokens_ = std::min(capacity_, tokens_ + elapsed.count() * rate_);
+    updated_ = now;
+}
+
+OutboundQueue::OutboundQueue(OutboundLimits limits, Clock::time_point now)
+    : limits_(limits), global_(limits.global_per_second, limits.global_burst, now)
+{
+    if (limits_.global_per_second <= 0 || limits_.chat_per_second <= 0 ||
+        limits_.group_per_second <= 0 || limits_.global_burst < 1) {
+        throw std::invalid_argument("Outbound rate limits must be positive");
+    }
+}
+
+void OutboundQueue::push(std::string chat_id, std::string text, Priority priority, Clock::time_point now) {
+    enqueue(Message{std::move(chat_id), std::move(text), priority, nullptr}, false, now);
+}
+
+void OutboundQueue::push(Message message, Clock::time_point now) {
+    enqueue(std::move(message), false, now);
+}
+
+std::optional<OutboundQueue::Message> OutboundQueue::pop(Clock::time_point now) {
+    evictIdle(now);
+    if (size_ == 0 || global_.ready_at(now) > now) {
+        return std::nullopt;
+    }
+
+    for (std::size_t lane = 0; lane < kLanes; ++lane) {
+        auto& rotation = rotation_[lane];
+        for (std::size_t visited = 0, n = rotation.size(); visited < n; ++visited) {
+            std::string chat_id = std::move(rotation.front());
+            rotation.pop_front();
+            Chat& c = chats_.at(chat_id);
+
+            if (chatReadyAt(c, now) > now) {
+                rotation.push_back(std::move(chat_id));
+                continue;
+            }
+
+            c.bucket.try_take(now);
+            global_.try_take(now);
+            Message message = std::move(c.lanes[lane].front());
+            c.lanes[lane].pop_front();
+            --c.queued;
+            --size_;
+            if (!c.lanes[lane].empty()) {
+                rotation.push_back(std::move(chat_id));
+            } else if (c.queued == 0) {
+                idle_.push_back(std::move(chat_id));
+            }
+            return message;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<OutboundQueue::Clock::time_point> OutboundQueue::next_ready(Clock::time_point now) {
+    evictIdle(now);
+    if (size_ == 0) {
+        return std::nullopt;
+    }
+    std::optional<Clock::time_point> earliest;
+    for (auto& [chat_id, c] : chats_) {
+        if (c.queued > 0) {
+            const auto ready = chatReadyAt(c, now);
+            if (!earliest || ready < *earliest) {
+                earliest = ready;
+            }
+        }
+    }
+    return std::max(*earliest, global_.ready_at(now));
+}
+
+void OutboundQueue::retry_after(Message message, std::chrono::seconds retry_after, Clock::time_point now) {
+    Chat& c = chat(message.chat_id, now);
+    c.paused_until = std::max(c.paused_until, now + retry_after);
+    enqueue(std::move(message), true, now);
+}
+
+std::size_t OutboundQueue::size() const noexcept {
+    return size_;
+}
+
+bool OutboundQueue::empty() const noexcept {
+    return size_ == 0;
+}
+
+std::size_t OutboundQueue::chat_count() const noexcept {
+    return chats_.size();
+}
+
+OutboundQueue::Chat& OutboundQueue::chat(const std::string& chat_id, Clock::time_point now) {
+    auto it = chats_.find(chat_id);
+    if (it == chats_.end()) {
+        // Group and supergroup ids are negative and get the lower group limit
+        const bool group = !chat_id.empty() && chat_id.front() == '-';
+        const double rate = group ? limits_.group_per_second : limits_.chat_per_second;
+        it = chats_.emplace(chat_id, Chat{TokenBucket(rate, 1.0, now), {}, {}, 0}).first;
+    }
+    return it->second;
+}
+
+OutboundQueue::Clock::time_point OutboundQueue::chatReadyAt(Chat& c, Clock::time_point now) {
+    return std::max(c.paused_until, c.bucket.ready_at(now));
+}
+
+void OutboundQueue::enqueue(Message message, bool front, Clock::time_point now) {
+    const auto lane = static_cast<std::size_t>(message.priority);
+    Chat& c = chat(message.chat_id, now);
+    auto& queue = c.lanes[lane];
+
+    if (queue.empty()) {
+        if (front) {
+            rotation_[lane].push_front(message.chat_id);
+        } else {
+            rotation_[lane].push_back(message.chat_id);
+        }
+    }
+    if (front) {
+        queue.push_front(std::move(message));
+    } else {
+        queue.push_back(std::move(message));
+    }
+    ++c.queued;
+    ++size_;
+}
+
+void OutboundQueue::evictIdle(Clock::time_point now) {
+    // Chats went idle in this order, so the first one still refilling ends the pass
+    while (!idle_.empty()) {
+        auto it = chats_.find(idle_.front());
+        if (it != chats_.end() && it->second.queued == 0) {
+            Chat& c = it->second;
+            if (c.paused_until > now || !c.bucket.full(now)) {
+                break;
+            }
+            chats_.erase(it);
+        }
+        idle_.pop_front();  // evicted, or busy again and queued here anew once it runs out
+    }
+}
@@ -1,49 +1,103 @@
 #include "periodic_tracker.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <stdexcept>
 
+static_assert(sizeof(PeriodicTracker) <= 64, "PeriodicTracker is kept per resident task");
+
+namespace {
+
+std::int32_t clampSeconds(std::int64_t seconds) {
+    return static_cast<std::int32_t>(std::clamp<std::int64_t>(seconds,
+        std::numeric_limits<std::int32_t>::min(), std::numeric_limits<std::int32_t>::max()));
+}
+
+} // namespace
+
 void PeriodicTracker::mark_execution(const PeriodicTracker::TimePoint& timestamp) {
-    if (first_execution_.has_value() && second_execution_.has_value()) {
-        throw std::logic_error("Maximum of two executions can be recorded");
+    if (count_ > 0) {
+        const auto previous = recent_[(count_ - 1) % kHistory];
+        const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timestamp - previous).count();
+        const std::int32_t interval = clampSeconds(seconds);
+        if (count_ == 1) {
+            ///< First interval: the statistics start from it
+            mean_interval_ = interval;
+            variance_ = 0.0;
+            min_interval_ = interval;
+            max_interval_ = interval;
+        } else {
+            ///< Incremental exponentially weighted mean and variance
+            const double diff = interval - mean_interval_;
+            const double increment = kSmoothing * diff;
+            mean_interval_ += increment;
+            variance_ = (1.0 - kSmoothing) * (variance_ + diff * increment);
+            min_interval_ = std::min(min_interval_, interval);
+            max_interval_ = std::max(max_interval_, interval);
+        }
     }
-
-    if (!first_execution_.has_value()) {
-        first_execution_ = timestamp;
-    } else {
-        second_execution_ = timestamp;
-        ///< Calculate interval (when both executions are recorded)
-        interval_ = std::chrono::duration_cast<std::chrono::seconds>(*second_execution_ - *first_execution_);
+    recent_[count_ % kHistory] = timestamp;
+    if (count_ < std::numeric_limits<std::uint32_t>::max()) {
+        ++count_;
     }
 }
 
 std::chrono::seconds PeriodicTracker::get_interval() const {
-    if (!interval_.has_value()) {
+    if (!is_interval_set()) {
         throw std::logic_error("Interval is not calculated yet");
     }
-    return *interval_;
+    return std::chrono::seconds(std::llround(mean_interval_));
+}
+
+double PeriodicTracker::get_interval_variance() const {
+    if (!is_interval_set()) {
+        throw std::logic_error("Interval is not calculated yet");
+    }
+    return variance_;
+}
+
+std::chrono::seconds PeriodicTracker::get_min_interval() const {
+    if (!is_interval_set()) {
+        throw std::logic_error("Interval is not calculated yet");
+    }
+    return std::chrono::seconds(min_interval_);
+}
+
+std::chrono::seconds PeriodicTracker::get_max_interval() const {
+    if (!is_interval_set()) {
+        throw std::logic_error("Interval is not calculated yet");
+    }
+    return std::chrono::seconds(max_interval_);
 }
 
 std::optional<PeriodicTracker::TimePoint> PeriodicTracker::get_next_execution_time() const {
-    if (!interval_.has_value() || !second_execution_.has_value()) {
+    if (!is_interval_set()) {
         return std::nullopt;
     }
-    return *second_execution_ + *interval_;
+    return *get_last_execution() + get_interval();
 }
 
 bool PeriodicTracker::is_interval_set() const noexcept {
-    return interval_.has_value();
+    return count_ >= 2;
 }
 
-const std::optional<PeriodicTracker::TimePoint>& PeriodicTracker::get_first_execution() const noexcept {
-    return first_execution_;
+std::uint32_t PeriodicTracker::execution_count() const noexcept {
+    return count_;
 }
 
-const std::optional<PeriodicTracker::TimePoint>& PeriodicTracker::get_second_execution() const noexcept {
-    return second_execution_;
+std::vector<PeriodicTracker::TimePoint> PeriodicTracker::recent_executions() const {
+    const std::size_t kept = std::min<std::size_t>(count_, kHistory);
+    std::vector<TimePoint> executions;
+    executions.reserve(kept);
+    for (std::size_t i = count_ - kept; i < count_; ++i) {
+        executions.push_back(recent_[i % kHistory]);
+    }
+    return executions;
 }
 
 std::optional<PeriodicTracker::TimePoint> PeriodicTracker::get_last_execution() const noexcept {
-    if (second_execution_.has_value()) {
-        return second_execution_;
+    if (count_ == 0) {
+        return std::nullopt;
     }
-    return first_execution_;
-}
\ No newline at end of file
+    return recent_[(count_ - 1) % kHistory];
+}
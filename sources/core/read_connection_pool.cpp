@@ -0,0 +1,60 @@
+#include "read_connection_pool.hpp"
+#include <stdexcept>
+
+ReadConnectionPool::ReadConnectionPool(const std::string& db_path, std::size_t size, int busy_timeout_ms) {
+    if (size == 0) {
+        throw std::invalid_argument("Read pool size must be positive");
+    }
+
+    connections_.reserve(size);
+    try {
+        for (std::size_t i = 0; i < size; ++i) {
+            Connection connection;
+            int rc = sqlite3_open_v2(
+                db_path.c_str(),
+                &connection.db,
+                SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX,
+                nullptr
+            );
+            if (rc != SQLITE_OK) {
+                std::string err = sqlite3_errmsg(connection.db);
+                sqlite3_close_v2(connection.db);
+                throw std::runtime_error("Ошибка открытия БД для чтения: " + err);
+            }
+            sqlite3_busy_timeout(connection.db, busy_timeout_ms);
+            connection.statements = std::make_unique<StatementCache>(connection.db);
+            connections_.push_back(std::move(connection));
+        }
+    } catch (...) {
+        close();
+        throw;
+    }
+}
+
+ReadConnectionPool::~ReadConnectionPool() {
+    close();
+}
+
+void ReadConnectionPool::close() noexcept {
+    for (auto& connection : connections_) {
+        connection.statements.reset();
+        sqlite3_close_v2(connection.db);
+    }
+    connections_.clear();
+}
+
+CachedStatement ReadConnectionPool::acquire(int query_id, const std::string& table, const StatementCache::SqlBuilder& build_sql) {
+    const std::size_t start = next_.fetch_add(1, std::memory_order_relaxed);
+    for (std::size_t i = 0; i < connections_.size(); ++i) {
+        auto& connection = connections_[(start + i) % connections_.size()];
+        if (auto stmt = connection.statements->try_acquire(query_id, table, build_sql)) {
+            return std::move(*stmt);
+        }
+    }
+    // Every connection is busy: queue on the one this call started from
+    return connections_[start % connections_.size()].statements->acquire(query_id, table, build_sql);
+}
+
+std::size_t ReadConnectionPool::size() const noexcept {
+    return connections_.size();
+}
@@ -0,0 +1,213 @@
+#include "recurrence_index.hpp"
+#include "task.hpp"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define TASKEBB_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using Kernel = RecurrenceIndex::Kernel;
+
+struct Columns {
+    const std::int64_t* last;
+    const std::int64_t* interval;
+    const std::int64_t* end;
+};
+
+// Entries [begin, end) contribute to the due bits of *word starting at bit begin % 64
+std::uint64_t evaluateScalar(const Columns& c, std::size_t begin, std::size_t end, std::int64_t now, std::int64_t* next) {
+    std::uint64_t word = 0;
+    for (std::size_t i = begin; i < end; ++i) {
+        const std::int64_t fire = c.last[i] + c.interval[i];
+        const bool fires = c.interval[i] > 0 && fire <= c.end[i];
+        next[i] = fires ? fire : RecurrenceIndex::kNever;
+        word |= static_cast<std::uint64_t>(fires && fire <= now) << (i % 64);
+    }
+    return word;
+}
+
+#ifdef TASKEBB_X86_KERNELS
+
+// Only the 64-entry blocks go through the vector kernels; the tail of the last word is scalar
+
+__attribute__((target("avx2")))
+std::uint64_t evaluateAvx2(const Columns& c, std::size_t begin, std::int64_t now, std::int64_t* next) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i never = _mm256_set1_epi64x(RecurrenceIndex::kNever);
+    const __m256i limit = _mm256_set1_epi64x(now);
+    std::uint64_t word = 0;
+    for (std::size_t i = 0; i < 64; i += 4) {
+        const std::size_t at = begin + i;
+        const __m256i last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c.last + at));
+        const __m256i interval = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c.interval + at));
+        const __m256i end = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c.end + at));
+        const __m256i fire = _mm256_add_epi64(last, interval);
+        // fires = interval > 0 && !(fire > end)
+        const __m256i fires = _mm256_andnot_si256(_mm256_cmpgt_epi64(fire, end), _mm256_cmpgt_epi64(interval, zero));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(next + at), _mm256_blendv_epi8(never, fire, fires));
+        const __m256i due = _mm256_andnot_si256(_mm256_cmpgt_epi64(fire, limit), fires);
+        word |= static_cast<std::uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(due))) << i;
+    }
+    return word;
+}
+
+__attribute__((target("sse4.2")))
+std::uint64_t evaluateSse42(const Columns& c, std::size_t begin, std::int64_t now, std::int64_t* next) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i never = _mm_set1_epi64x(RecurrenceIndex::kNever);
+    const __m128i limit = _mm_set1_epi64x(now);
+    std::uint64_t word = 0;
+    for (std::size_t i = 0; i < 64; i += 2) {
+        const std::size_t at = begin + i;
+        const __m128i last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c.last + at));
+        const __m128i interval = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c.interval + at));
+        const __m128i end = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c.end + at));
+        const __m128i fire = _mm_add_epi64(last, interval);
+        const __m128i fires = _mm_andnot_si128(_mm_cmpgt_epi64(fire, end), _mm_cmpgt_epi64(interval, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(next + at), _mm_blendv_epi8(never, fire, fires));
+        const __m128i due = _mm_andnot_si128(_mm_cmpgt_epi64(fire, limit), fires);
+        word |= static_cast<std::uint64_t>(_mm_movemask_pd(_mm_castsi128_pd(due))) << i;
+    }
+    return word;
+}
+
+#endif
+
+Kernel detectKernel() noexcept {
+#ifdef TASKEBB_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Kernel::Avx2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return Kernel::Sse42;
+    }
+#endif
+    return Kernel::Scalar;
+}
+
+} // namespace
+
+bool RecurrenceIndex::add(const Task& task, PeriodicTracker::TimePoint now) {
+    auto next = task.next_execution_time(now);
+    if (!next) {
+        return false;
+    }
+    // Stored as (anchor, step) so that the entry fires at exactly the time the task reports
+    const std::int64_t fire = std::chrono::system_clock::to_time_t(*next);
+    std::int64_t interval = std::chrono::duration_cast<std::chrono::seconds>(task.get_interval()).count();
+    if (auto last = task.get_tracker().get_last_execution(); last && *last < *next) {
+        interval = fire - std::chrono::system_clock::to_time_t(*last);
+    }
+    const std::int64_t end_date = task.get_end_date().isValid() ? task.get_end_date().toSecsSinceEpoch() : kNoEndDate;
+    add(task.get_id_view(), fire - interval, interval, end_date);
+    return true;
+}
+
+std::size_t RecurrenceIndex::add(std::string_view id, std::int64_t last_execution, std::int64_t interval, std::int64_t end_date) {
+    last_execution_.push_back(last_execution);
+    interval_.push_back(interval);
+    end_date_.push_back(end_date);
+    ids_.emplace_back(id);
+    return ids_.size() - 1;
+}
+
+void RecurrenceIndex::mark_execution(std::size_t i, std::int64_t timestamp) noexcept {
+    last_execution_[i] = timestamp;
+}
+
+std::size_t RecurrenceIndex::evaluate(std::int64_t now, std::span<std::int64_t> next, std::span<std::uint64_t> due,
+                                      Kernel kernel) const {
+    const std::size_t count = size();
+    const std::size_t words = (count + 63) / 64;
+    if (next.size() < count || due.size() < words) {
+        throw std::invalid_argument("RecurrenceIndex::evaluate: output spans are too small");
+    }
+    if (kernel == Kernel::Best) {
+        kernel = best_kernel();
+    } else if (!supports(kernel)) {
+        throw std::invalid_argument("RecurrenceIndex::evaluate: kernel is not supported by this CPU");
+    }
+
+    const Columns columns{last_execution_.data(), interval_.data(), end_date_.data()};
+    std::size_t due_count = 0;
+    for (std::size_t w = 0; w < words; ++w) {
+        const std::size_t begin = w * 64;
+        const std::size_t end = std::min(begin + 64, count);
+        std::uint64_t word;
+#ifdef TASKEBB_X86_KERNELS
+        if (end - begin == 64 && kernel == Kernel::Avx2) {
+            word = evaluateAvx2(columns, begin, now, next.data());
+        } else if (end - begin == 64 && kernel == Kernel::Sse42) {
+            word = evaluateSse42(columns, begin, now, next.data());
+        } else
+#endif
+        {
+            word = evaluateScalar(columns, begin, end, now, next.data());
+        }
+        due[w] = word;
+        due_count += static_cast<std::size_t>(std::popcount(word));
+    }
+    return due_count;
+}
+
+std::vector<std::size_t> RecurrenceIndex::due(std::int64_t now) const {
+    std::vector<std::int64_t> next(size());
+    std::vector<std::uint64_t> mask((size() + 63) / 64);
+    std::vector<std::size_t> positions;
+    positions.reserve(evaluate(now, next, mask));
+    for (std::size_t w = 0; w < mask.size(); ++w) {
+        for (std::uint64_t word = mask[w]; word != 0; word &= word - 1) {
+            positions.push_back(w * 64 + static_cast<std::size_t>(std::countr_zero(word)));
+        }
+    }
+    return positions;
+}
+
+bool RecurrenceIndex::supports(Kernel kernel) noexcept {
+    static const Kernel best = detectKernel();
+    switch (kernel) {
+    case Kernel::Best:
+    case Kernel::Scalar:
+        return true;
+    case Kernel::Sse42:
+        return best == Kernel::Sse42 || best == Kernel::Avx2;
+    case Kernel::Avx2:
+        return best == Kernel::Avx2;
+    }
+    return false;
+}
+
+RecurrenceIndex::Kernel RecurrenceIndex::best_kernel() noexcept {
+    if (supports(Kernel::Avx2)) {
+        return Kernel::Avx2;
+    }
+    return supports(Kernel::Sse42) ? Kernel::Sse42 : Kernel::Scalar;
+}
+
+const std::string& RecurrenceIndex::id(std::size_t i) const {
+    return ids_.at(i);
+}
+
+std::size_t RecurrenceIndex::size() const noexcept {
+    return ids_.size();
+}
+
+void RecurrenceIndex::reserve(std::size_t count) {
+    last_execution_.reserve(count);
+    interval_.reserve(count);
+    end_date_.reserve(count);
+    ids_.reserve(count);
+}
+
+void RecurrenceIndex::clear() noexcept {
+    last_execution_.clear();
+    interval_.clear();
+    end_date_.clear();
+    ids_.clear();
+}
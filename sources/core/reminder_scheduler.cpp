@@ -0,0 +1,94 @@
+#include "reminder_scheduler.hpp"
+
+void ReminderScheduler::schedule(std::string_view task_id, TimePoint when) {
+    const std::uint64_t generation = next_generation_++;
+    auto it = live_.find(task_id);
+    if (it == live_.end()) {
+        it = live_.emplace(std::string(task_id), generation).first;
+    } else {
+        it->second = generation;
+    }
+    heap_.push(Entry{when, generation, it->first});
+    compactIfNeeded();
+}
+
+bool ReminderScheduler::cancel(std::string_view task_id) {
+    auto it = live_.find(task_id);
+    if (it == live_.end()) {
+        return false;
+    }
+    live_.erase(it);
+    compactIfNeeded();
+    return true;
+}
+
+void ReminderScheduler::clear() noexcept {
+    heap_ = {};
+    live_.clear();
+}
+
+std::optional<ReminderScheduler::TimePoint> ReminderScheduler::next_due() {
+    dropStale();
+    if (heap_.empty()) {
+        return std::nullopt;
+    }
+    return heap_.top().when;
+}
+
+std::vector<std::string> ReminderScheduler::pop_due(TimePoint now) {
+    std::vector<std::string> due;
+    dropStale();
+    while (!heap_.empty() && heap_.top().when <= now) {
+        Entry entry = heap_.top();
+        heap_.pop();
+        live_.erase(entry.task_id);
+        due.push_back(std::move(entry.task_id));
+        dropStale();
+    }
+    return due;
+}
+
+std::size_t ReminderScheduler::size() const noexcept {
+    return live_.size();
+}
+
+bool ReminderScheduler::contains(std::string_view task_id) const {
+    return live_.find(task_id) != live_.end();
+}
+
+std::optional<ReminderScheduler::TimePoint> ReminderScheduler::fire_time(const Task& task, TimePoint now) {
+    if (!task.is_recurring()) {
+        if (task.is_completed()) {
+            return now;
+        }
+        return std::nullopt;
+    }
+    // Same rule as the stored next_execution column
+    return task.next_execution_time(now);
+}
+
+bool ReminderScheduler::isLive(const Entry& entry) const {
+    auto it = live_.find(entry.task_id);
+    return it != live_.end() && it->second == entry.generation;
+}
+
+void ReminderScheduler::dropStale() {
+    while (!heap_.empty() && !isLive(heap_.top())) {
+        heap_.pop();
+    }
+}
+
+void ReminderScheduler::compactIfNeeded() {
+    if (heap_.size() <= 2 * live_.size() + 64) {
+        return;
+    }
+    std::vector<Entry> entries;
+    entries.reserve(live_.size());
+    while (!heap_.empty()) {
+        if (isLive(heap_.top())) {
+            entries.push_back(heap_.top());
+        }
+        heap_.pop();
+    }
+    heap_ = std::priority_queue<Entry, std::vector<Entry>, Later>(Later(), std::move(entries));
+}
@@ -0,0 +1,33 @@
+#include "retry_backoff.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+RetryBackoff::RetryBackoff(std::chrono::milliseconds initial, std::chrono::milliseconds max, std::uint32_t seed)
+    : initial_(initial), max_(max), rng_(seed)
+{
+    if (initial_.count() <= 0 || max_ < initial_) {
+        throw std::invalid_argument("Invalid backoff range");
+    }
+}
+
+std::chrono::milliseconds RetryBackoff::next() {
+    // Stop doubling once the cap is reached so the shift cannot overflow
+    std::chrono::milliseconds ceiling = initial_;
+    for (int i = 0; i < failures_ && ceiling < max_; ++i) {
+        ceiling *= 2;
+    }
+    ceiling = std::min(ceiling, max_);
+    ++failures_;
+
+    const auto half = ceiling.count() / 2;
+    std::uniform_int_distribution<std::chrono::milliseconds::rep> jitter(0, ceiling.count() - half);
+    return std::chrono::milliseconds(half + jitter(rng_));
+}
+
+void RetryBackoff::reset() noexcept {
+    failures_ = 0;
+}
+
+int RetryBackoff::failures() const noexcept {
+    return failures_;
+}
@@ -0,0 +1,75 @@
+#include "schema_migrator.hpp"
+#include "sqlite_transaction.hpp"
+#include <stdexcept>
+
+SchemaMigrator::SchemaMigrator(sqlite3* db, std::recursive_mutex& connection_mutex)
+    : db_(db), mutex_(connection_mutex) {}
+
+void SchemaMigrator::add(int version, std::string description, std::string sql) {
+    add(version, std::move(description), [sql = std::move(sql)](sqlite3* db) { exec(db, sql); });
+}
+
+void SchemaMigrator::add(int version, std::string description, Step step) {
+    if (version != latest_version() + 1) {
+        throw std::invalid_argument("Migrations must be numbered consecutively from 1");
+    }
+    migrations_.push_back({version, std::move(description), std::move(step)});
+}
+
+int SchemaMigrator::latest_version() const noexcept {
+    return migrations_.empty() ? 0 : migrations_.back().version;
+}
+
+int SchemaMigrator::current_version() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db_, "PRAGMA user_version;", -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("SQLite error (read user_version): " + std::string(sqlite3_errmsg(db_)));
+    }
+    int version = 0;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        version = sqlite3_column_int(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    return version;
+}
+
+int SchemaMigrator::migrate() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    const int current = current_version();
+    if (current == latest_version()) {
+        return 0;
+    }
+    if (current > latest_version()) {
+        throw std::runtime_error("Database schema version " + std::to_string(current) +
+                                 " is newer than supported version " + std::to_string(latest_version()));
+    }
+
+    int applied = 0;
+    for (const auto& migration : migrations_) {
+        if (migration.version <= current) {
+            continue;
+        }
+        try {
+            SqliteTransaction transaction(db_, mutex_);
+            migration.step(db_);
+            // user_version lives in the database header, so it is part of the same transaction
+            exec(db_, "PRAGMA user_version = " + std::to_string(migration.version) + ";");
+            transaction.commit();
+        } catch (const std::exception& e) {
+            throw std::runtime_error("Migration " + std::to_string(migration.version) +
+                                     " (" + migration.description + ") failed: " + e.what());
+        }
+        ++applied;
+    }
+    return applied;
+}
+
+void SchemaMigrator::exec(sqlite3* db, const std::string& sql) {
+    char* error = nullptr;
+    if (sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &error) != SQLITE_OK) {
+        std::string message = error ? error : sqlite3_errmsg(db);
+        sqlite3_free(error);
+        throw std::runtime_error("SQLite error (migration): " + message);
+    }
+}
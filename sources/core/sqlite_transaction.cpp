@@ -0,0 +1,68 @@
+#include "sqlite_transaction.hpp"
+#include <atomic>
+#include <stdexcept>
+
+namespace {
+
+std::atomic<unsigned long> savepoint_counter{0};
+
+} // namespace
+
+SqliteTransaction::SqliteTransaction(sqlite3* db, std::recursive_mutex& connection_mutex)
+    : db_(db), lock_(connection_mutex)
+{
+    if (sqlite3_get_autocommit(db_)) {
+        exec("BEGIN IMMEDIATE;");
+    } else {
+        savepoint_ = "sp_" + std::to_string(++savepoint_counter);
+        exec("SAVEPOINT " + savepoint_ + ";");
+    }
+    active_ = true;
+}
+
+SqliteTransaction::~SqliteTransaction() {
+    rollback();
+}
+
+void SqliteTransaction::commit() {
+    if (!active_) {
+        throw std::logic_error("Transaction is not active");
+    }
+    try {
+        exec(savepoint_.empty() ? "COMMIT;" : "RELEASE " + savepoint_ + ";");
+        active_ = false;
+    } catch (...) {
+        rollback();
+        throw;
+    }
+}
+
+void SqliteTransaction::rollback() noexcept {
+    if (!active_) {
+        return;
+    }
+    active_ = false;
+    if (savepoint_.empty()) {
+        // SQLite may already have rolled back on its own (e.g. SQLITE_FULL)
+        if (!sqlite3_get_autocommit(db_)) {
+            sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+        }
+    } else {
+        const std::string sql = "ROLLBACK TO " + savepoint_ + "; RELEASE " + savepoint_ + ";";
+        sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, nullptr);
+    }
+}
+
+bool SqliteTransaction::is_active() const noexcept {
+    return active_;
+}
+
+void SqliteTransaction::exec(const std::string& sql) {
+    char* err = nullptr;
+    int rc = sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, &err);
+    if (rc != SQLITE_OK) {
+        std::string message = err ? err : sqlite3_errmsg(db_);
+        sqlite3_free(err);
+        throw std::runtime_error("SQLite error (" + sql + "): " + message);
+    }
+}
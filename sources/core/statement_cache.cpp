@@ -0,0 +1,114 @@
+#include "statement_cache.hpp"
+#include <stdexcept>
+
+CachedStatement::CachedStatement(sqlite3_stmt* stmt, std::unique_lock<std::recursive_mutex> lock, bool owned) noexcept
+    : stmt_(stmt), lock_(std::move(lock)), owned_(owned) {}
+
+CachedStatement::~CachedStatement() {
+    release();
+}
+
+void CachedStatement::release() noexcept {
+    if (stmt_) {
+        if (owned_) {
+            sqlite3_finalize(stmt_);
+        } else {
+            sqlite3_reset(stmt_);
+            sqlite3_clear_bindings(stmt_);
+        }
+        stmt_ = nullptr;
+    }
+    if (lock_.owns_lock()) {
+        lock_.unlock();
+    }
+}
+
+CachedStatement::CachedStatement(CachedStatement&& other) noexcept
+    : stmt_(other.stmt_), lock_(std::move(other.lock_)), owned_(other.owned_) {
+    other.stmt_ = nullptr;
+}
+
+CachedStatement& CachedStatement::operator=(CachedStatement&& other) noexcept {
+    if (this != &other) {
+        release();
+        stmt_ = other.stmt_;
+        lock_ = std::move(other.lock_);
+        owned_ = other.owned_;
+        other.stmt_ = nullptr;
+    }
+    return *this;
+}
+
+CachedStatement::operator sqlite3_stmt*() const noexcept {
+    return stmt_;
+}
+
+void CachedStatement::reset() noexcept {
+    if (stmt_) {
+        sqlite3_reset(stmt_);
+        sqlite3_clear_bindings(stmt_);
+    }
+}
+
+StatementCache::StatementCache(sqlite3* db) : db_(db) {
+    if (!db_) {
+        throw std::invalid_argument("StatementCache requires an open connection");
+    }
+}
+
+StatementCache::~StatementCache() {
+    clear();
+}
+
+CachedStatement StatementCache::acquire(int query_id, const std::string& table, const SqlBuilder& build_sql) {
+    return lease(std::unique_lock<std::recursive_mutex>(mutex_), query_id, table, build_sql);
+}
+
+std::optional<CachedStatement> StatementCache::try_acquire(int query_id, const std::string& table, const SqlBuilder& build_sql) {
+    std::unique_lock<std::recursive_mutex> lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return std::nullopt;
+    }
+    return lease(std::move(lock), query_id, table, build_sql);
+}
+
+CachedStatement StatementCache::lease(std::unique_lock<std::recursive_mutex> lock, int query_id, const std::string& table, const SqlBuilder& build_sql) {
+    Key key{query_id, table};
+    auto it = statements_.find(key);
+    if (it == statements_.end()) {
+        sqlite3_stmt* stmt = prepare(build_sql());
+        it = statements_.emplace(std::move(key), stmt).first;
+    } else if (sqlite3_stmt_busy(it->second)) {
+        // Same query re-entered on this thread (e.g. from a row callback): use a one-off statement
+        return CachedStatement(prepare(build_sql()), std::move(lock), true);
+    }
+
+    return CachedStatement(it->second, std::move(lock));
+}
+
+sqlite3_stmt* StatementCache::prepare(const std::string& sql) {
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v3(db_, sql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        throw std::runtime_error("SQLite error (prepare cached statement): " + std::string(sqlite3_errmsg(db_)));
+    }
+    return stmt;
+}
+
+void StatementCache::clear() noexcept {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    for (auto& [key, stmt] : statements_) {
+        sqlite3_finalize(stmt);
+    }
+    statements_.clear();
+}
+
+std::size_t StatementCache::size() const noexcept {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return statements_.size();
+}
+
+std::recursive_mutex& StatementCache::mutex() noexcept {
+    return mutex_;
+}
@@ -89,6 +89,30 @@ std::string Task::get_description() const {
     return description_;
 }
 
+std::string_view Task::get_id_view() const noexcept {
+    return std::string_view(id_);
+}
+
+std::string_view Task::get_title_view() const noexcept {
+    return title_;
+}
+
+std::string_view Task::get_description_view() const noexcept {
+    return description_;
+}
+
+std::string Task::get_owner_chat_id() const {
+    return owner_chat_id_;
+}
+
+std::string_view Task::get_owner_chat_id_view() const noexcept {
+    return owner_chat_id_;
+}
+
+void Task::set_owner_chat_id(const std::string& chat_id) {
+    owner_chat_id_ = chat_id;
+}
+
 std::chrono::hours Task::get_interval() const noexcept{ 
     return interval_; 
 }
@@ -103,6 +127,12 @@ void Task::set_interval(std::chrono::hours interval) {
 
 void Task::mark_completed(bool status) {
     this->is_completed_ = status;
+    // Keep the stored status in step, so statistics and queries by status see the change
+    if (status) {
+        status_ = Completed;
+    } else if (status_ == Completed) {
+        status_ = Active;
+    }
 }
 
 void Task::set_id(const std::string& id) {
@@ -125,6 +155,7 @@ void Task::set_description(const std::string& description) {
 void Task::mark_execution(const PeriodicTracker::TimePoint& timestamp) {
     if (is_recurring_) {
         tracker_.mark_execution(timestamp);
+        next_execution_.reset();  // the stored schedule predates this execution
     }
 }
 
@@ -159,10 +190,64 @@ void Task::set_deadline(const QDateTime& deadline) {
     }
 }
 
+void Task::restore_deadline(const QDateTime& deadline) noexcept {
+    deadline_ = deadline;
+}
+
 void Task::set_end_date(const QDateTime& endDate) {
     endDate_ = endDate;
 }
 
+void Task::assign_id(std::string_view id) noexcept {
+    size_t len = id.size() < sizeof(id_) - 1 ? id.size() : sizeof(id_) - 1;
+    id.copy(id_, len);
+    id_[len] = '\0';
+}
+
+void Task::assign_title(std::string_view title) {
+    title_.assign(title.data(), title.size());
+}
+
+void Task::assign_description(std::string_view description) {
+    description_.assign(description.data(), description.size());
+}
+
+void Task::assign_owner_chat_id(std::string_view chat_id) {
+    owner_chat_id_.assign(chat_id.data(), chat_id.size());
+}
+
+void Task::clear_executions() noexcept {
+    tracker_ = PeriodicTracker();
+    next_execution_.reset();
+}
+
+void Task::restore_next_execution(std::optional<PeriodicTracker::TimePoint> next) noexcept {
+    next_execution_ = next;
+}
+
+std::optional<PeriodicTracker::TimePoint> Task::next_execution_time(PeriodicTracker::TimePoint now) const {
+    if (!is_recurring_ || status_ != Active || interval_.count() <= 0) {
+        return std::nullopt;
+    }
+
+    std::optional<PeriodicTracker::TimePoint> next = next_execution_;
+    if (!next) {
+        next = tracker_.get_next_execution_time();
+    }
+    if (!next) {
+        if (auto last = tracker_.get_last_execution()) {
+            next = *last + interval_;
+        } else {
+            next = now + interval_;
+        }
+    }
+
+    if (endDate_.isValid() && *next > PeriodicTracker::Clock::from_time_t(endDate_.toSecsSinceEpoch())) {
+        return std::nullopt;
+    }
+    return next;
+}
+
 Task::Type Task::get_type() const noexcept {
     return type_;
 }
@@ -184,6 +269,7 @@ void Task::set_type(Type type) {
         throw std::invalid_argument("Invalid task type");
     }
     type_ = type;
+    is_recurring_ = (type == Recurring);
 }
 
 void Task::set_status(Status status) {
@@ -191,6 +277,7 @@ void Task::set_status(Status status) {
         throw std::invalid_argument("Invalid task status");
     }
     status_ = status;
+    is_completed_ = (status == Completed);
 }
 
 bool Task::is_valid() const {
@@ -0,0 +1,71 @@
+#include "task_statistics.hpp"
+
+void TaskStatistics::Delta::add(Task::Status status, Task::Type type, int n) noexcept {
+    counts[TaskStatistics::index(status, type)] += n;
+}
+
+void TaskStatistics::Delta::remove(Task::Status status, Task::Type type, int n) noexcept {
+    counts[TaskStatistics::index(status, type)] -= n;
+}
+
+TaskStatistics::TaskStatistics() noexcept {
+    clear();
+}
+
+void TaskStatistics::clear() noexcept {
+    for (auto& counter : counts_) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+int TaskStatistics::index(Task::Status status, Task::Type type) noexcept {
+    return static_cast<int>(status) * kTypes + static_cast<int>(type);
+}
+
+void TaskStatistics::set(Task::Status status, Task::Type type, int count) noexcept {
+    counts_[index(status, type)].store(count, std::memory_order_relaxed);
+}
+
+void TaskStatistics::add(Task::Status status, Task::Type type, int n) noexcept {
+    counts_[index(status, type)].fetch_add(n, std::memory_order_relaxed);
+}
+
+void TaskStatistics::remove(Task::Status status, Task::Type type, int n) noexcept {
+    counts_[index(status, type)].fetch_sub(n, std::memory_order_relaxed);
+}
+
+void TaskStatistics::apply(const Delta& delta) noexcept {
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+        if (delta.counts[i] != 0) {
+            counts_[i].fetch_add(delta.counts[i], std::memory_order_relaxed);
+        }
+    }
+}
+
+int TaskStatistics::count(Task::Status status, Task::Type type) const noexcept {
+    return counts_[index(status, type)].load(std::memory_order_relaxed);
+}
+
+int TaskStatistics::count(Task::Status status) const noexcept {
+    int sum = 0;
+    for (int type = 0; type < kTypes; ++type) {
+        sum += count(status, static_cast<Task::Type>(type));
+    }
+    return sum;
+}
+
+int TaskStatistics::total() const noexcept {
+    int sum = 0;
+    for (const auto& counter : counts_) {
+        sum += counter.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+int TaskStatistics::completed() const noexcept {
+    return count(Task::Status::Completed);
+}
+
+int TaskStatistics::pending() const noexcept {
+    return count(Task::Status::Active);
+}
@@ -3,7 +3,8 @@
 #include <cmath>
 
 TaskTemplate::TaskTemplate(const std::string& title, const std::string& description, TemplateType type, int interval)
-    : base_task_(title, description, static_cast<Task::Type>(type)),
+    : base_task_(title, description, static_cast<Task::Type>(type), QDateTime(),
+                 type == PERIODIC ? std::chrono::hours(interval) : std::chrono::hours(0)),
       template_type_(type),
       recurrence_type_(RecurrenceType::CUSTOM),
       custom_interval_hours_(interval), 
@@ -11,7 +12,7 @@ TaskTemplate::TaskTemplate(const std::string& title, const std::string& descript
 {}
 
 TaskTemplate::TaskTemplate(const std::string& title, const std::string& description, int interval_hours)
-    : base_task_(title, description, Task::Type::Recurring),
+    : base_task_(title, description, Task::Type::Recurring, QDateTime(), std::chrono::hours(interval_hours)),
       template_type_(TemplateType::PERIODIC),
       recurrence_type_(RecurrenceType::CUSTOM),
       custom_interval_hours_(interval_hours),
@@ -1,119 +1,226 @@
 #include "telegram_bot.hpp"
 #include "curl_handle.hpp"
+#include "retry_backoff.hpp"
 #include <sstream>
 #include <algorithm>
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <unordered_map>
 #include <cctype>
 #include <codecvt>
+#include <charconv>
 #include <nlohmann/json.hpp>
 
+// Recurring reminders sent per timer round; the rest follow in the next round at once
+static constexpr std::size_t kReminderBatch = 256;
+
 TelegramBot::TelegramBot(const ConfigManager& config, DatabaseManager& db, QObject* parent)
-    : QObject(parent), bot_token_(config.get_bot_token()), db_(db), running_(false) 
+    : QObject(parent), bot_token_(config.get_bot_token()), db_(db)
 {
     if (bot_token_.empty()) {
         throw std::invalid_argument("Bot token is not configured!");
     }
-    
-    reminderTimer.setInterval(60000); 
+
+    MessageSenderOptions sender_options;
+    sender_options.api_base_url = config.get_telegram_api_url();
+    sender_ = std::make_unique<MessageSender>(bot_token_, sender_options);
+    async_sender_ = std::make_unique<AsyncSender>(*sender_, static_cast<std::size_t>(config.get_telegram_max_in_flight()));
+
+    webhook_mode_ = config.get_telegram_mode() == "webhook";
+    if (webhook_mode_) {
+        webhook_options_.address = config.get_webhook_address();
+        webhook_options_.port = static_cast<quint16>(config.get_webhook_port());
+        webhook_options_.path = config.get_webhook_path();
+        webhook_options_.secret = config.get_webhook_secret();
+    }
+
+    reminderTimer.setSingleShot(true);
+    reminderTimer.setTimerType(Qt::PreciseTimer);
     connect(&reminderTimer, &QTimer::timeout, this, &TelegramBot::check_reminders);
-    reminderTimer.start();
+
+    const auto leads = config.get_deadline_leads();
+    db_.setDeadlineLeads(leads);
+    rebuildSchedule();
+
+    registerCommands();
+
+    outboundTimer_.setSingleShot(true);
+    connect(&outboundTimer_, &QTimer::timeout, this, &TelegramBot::flush_outbound);
+
+    // Last, once nothing can throw any more: the observer must not outlive a half-built bot.
+    // Writes may come from any thread: the fire time is computed while the task is at hand,
+    // the schedule itself is only touched on the bot's thread
+    task_observer_ = ScopedTaskObserver(db_, [this](DatabaseManager::TaskChange change, std::string_view id, const Task* task) {
+        std::optional<ReminderScheduler::TimePoint> when;
+        if (change != DatabaseManager::TaskChange::Deleted && task) {
+            when = ReminderScheduler::fire_time(*task, std::chrono::system_clock::now());
+        }
+        QMetaObject::invokeMethod(this,
+            [this, task_id = std::string(id), when]() { reschedule(task_id, when); },
+            Qt::QueuedConnection
+        );
+    });
 }
 
 TelegramBot::~TelegramBot() {
+    task_observer_.reset();
     stop();
+    // Pending completions are aborted here, while the bot they post to still exists
+    async_sender_.reset();
 }
 
 void TelegramBot::start() {
-    running_ = true;
+    if (running_.exchange(true)) {
+        return;
+    }
+    if (webhook_mode_) {
+        webhook_ = std::make_unique<WebhookServer>(webhook_options_, [this](const std::string& body) {
+            if (auto message = TelegramUpdateParser::parse_webhook(body)) {
+                dispatch(std::move(*message));
+            }
+        });
+        try {
+            webhook_->listen();
+        } catch (...) {
+            webhook_.reset();
+            running_ = false;
+            throw;
+        }
+        return;
+    }
     polling_thread_ = std::thread(&TelegramBot::pollingLoop, this);
-
-    reminderTimer.setInterval(60000);
-    connect(&reminderTimer, &QTimer::timeout, this, &TelegramBot::check_reminders);
-    reminderTimer.start();
 }
 
 void TelegramBot::stop() {
-    running_ = false;
+    {
+        // Under the lock so waitUnlessStopped() cannot miss the notification
+        std::lock_guard<std::mutex> lock(stop_mutex_);
+        running_ = false;
+    }
+    // Wakes the loop whether it waits for getUpdates or sleeps between retries
+    curl_multi_wakeup(polling_multi_);
+    stop_cv_.notify_all();
     if (polling_thread_.joinable()) {
-        auto start = std::chrono::steady_clock::now();
-        while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500)) {
-            if (!polling_thread_.joinable()) break;
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        }
-        if (polling_thread_.joinable()) {
-            polling_thread_.detach();
-        }
+        polling_thread_.join();
+    }
+    if (webhook_) {
+        webhook_->close();
+        webhook_.reset();
     }
 }
 
+// "1 д", "1 ч 30 мин", "10 мин" for deadline reminders
+static std::string formatLead(std::chrono::seconds lead) {
+    using namespace std::chrono;
+    const auto days = duration_cast<hours>(lead).count() / 24;
+    const auto hours_left = duration_cast<hours>(lead).count() % 24;
+    const auto minutes_left = duration_cast<minutes>(lead).count() % 60;
+    std::string text;
+    auto append = [&text](long long value, const char* unit) {
+        if (value > 0) {
+            text += (text.empty() ? "" : " ") + std::to_string(value) + " " + unit;
+        }
+    };
+    append(days, "д");
+    append(hours_left, "ч");
+    append(minutes_left, "мин");
+    return text.empty() ? std::to_string(lead.count()) + " с" : text;
+}
+
 static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* output) {
     size_t total_size = size * nmemb;
     output->append(static_cast<char*>(contents), total_size);
     return total_size;
 }
 
+CURLcode TelegramBot::performPoll(CURL* curl) {
+    curl_multi_add_handle(polling_multi_, curl);
+    CURLcode result = CURLE_ABORTED_BY_CALLBACK;
+    while (running_) {
+        int still_running = 0;
+        curl_multi_perform(polling_multi_, &still_running);
+        int remaining = 0;
+        if (CURLMsg* message = curl_multi_info_read(polling_multi_, &remaining)) {
+            if (message->msg == CURLMSG_DONE) {
+                result = message->data.result;
+                break;
+            }
+        }
+        // Returns on socket activity, or at once after stop() called curl_multi_wakeup
+        curl_multi_poll(polling_multi_, nullptr, 0, 1000, nullptr);
+    }
+    curl_multi_remove_handle(polling_multi_, curl);
+    return result;
+}
+
+bool TelegramBot::waitUnlessStopped(std::chrono::milliseconds delay) {
+    std::unique_lock<std::mutex> lock(stop_mutex_);
+    return !stop_cv_.wait_for(lock, delay, [this] { return !running_; });
+}
+
 void TelegramBot::pollingLoop() {
     try {
         CurlHandle curl;
+        // Both keep their capacity from one poll to the next
         std::string response;
-        long last_update_id = 0;
+        TelegramUpdateParser parser;
+        std::int64_t last_update_id = 0;
+        RetryBackoff backoff;
 
         curl_easy_setopt(curl, CURLOPT_TIMEOUT, 25L);
         curl_easy_setopt(curl, CURLOPT_USERAGENT, "TaskEbbBot/1.0");
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+        // On success the next long poll starts at once; failures back off with jitter
+        auto retryLater = [&]() {
+            response.clear();
+            auto delay = backoff.next();
+            std::cerr << "[WARN] Polling retry in " << delay.count() << " ms" << std::endl;
+            return waitUnlessStopped(delay);
+        };
+
         while (running_) {
-            std::string url = "https://api.telegram.org/bot" + bot_token_ + 
-                "/getUpdates?timeout=20&offset=" + 
+            std::string url = sender_->method_url("getUpdates") +
+                "?timeout=20&offset=" + 
                 std::to_string(last_update_id + 1);
 
             curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
             curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
 
-            CURLcode res = curl_easy_perform(curl);
-            
-            if (res != CURLE_OK) {
-                std::cerr << "[ERROR] Polling request failed: " << curl_easy_strerror(res) << std::endl;
-                response.clear();
-                std::this_thread::sleep_for(std::chrono::seconds(2));
+            CURLcode res = performPoll(curl);
+            if (!running_) {
+                break;
+            }
+
+            long http_status = 0;
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_status);
+            if (res != CURLE_OK || http_status != 200) {
+                std::cerr << "[ERROR] Polling request failed: " << curl_easy_strerror(res)
+                          << " (HTTP " << http_status << ")" << std::endl;
+                if (!retryLater()) {
+                    break;
+                }
                 continue;
             }
 
-            ///< json parsing
             try {
-                nlohmann::json json_response = nlohmann::json::parse(response);
-                
-                if (json_response["ok"] == true) {
-                    for (const auto& update : json_response["result"]) {
-                        last_update_id = update["update_id"].get<long>();
-                        
-                        if (update.contains("message") && 
-                            update["message"].contains("text")) {
-                            
-                            const auto& message = update["message"];
-                            std::string chat_id = std::to_string(
-                                message["chat"]["id"].get<int64_t>()
-                            );
-                            std::string text = message["text"].get<std::string>();
-                            
-                            QMetaObject::invokeMethod(this, 
-                                [this, text, chat_id]() {
-                                    processMessage(text, chat_id);
-                                },
-                                Qt::QueuedConnection
-                            );
-                        }
-                    }
+                for (auto& message : parser.parse(response, last_update_id)) {
+                    dispatch(std::move(message));
                 }
+                backoff.reset();
             } catch (const std::exception& e) {
                 std::cerr << "[ERROR] JSON parsing failed: " << e.what() 
                         << "\nResponse: " << response << std::endl;
+                if (!retryLater()) {
+                    break;
+                }
+                continue;
             }
 
             response.clear();
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
         }
     } catch (const std::exception& e) {
         std::cerr << "[FATAL] Polling loop crashed: " << e.what() << std::endl;
@@ -121,138 +228,296 @@ void TelegramBot::pollingLoop() {
     std::cout << "Polling loop stopped" << std::endl;
 }
 
-std::vector<std::string> TelegramBot::split(const std::string& s, char delimiter) {
-    std::vector<std::string> tokens;
-    std::string token;
-    std::istringstream tokenStream(s);
-    while (std::getline(tokenStream, token, delimiter)) {
-        tokens.push_back(token);
+void TelegramBot::dispatch(IncomingMessage message) {
+    QMetaObject::invokeMethod(this,
+        [this, message = std::move(message)]() {
+            processMessage(message.text, message.chat_id);
+        },
+        Qt::QueuedConnection
+    );
+}
+
+void TelegramBot::processMessage(const std::string& text, const std::string& chat_id) {
+    std::cout << "[DEBUG] Обработка сообщения: " << text << " от chat_id: " << chat_id << std::endl;
+    try {
+        router_.dispatch(chat_id, text);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] Command failed: " << e.what() << std::endl;
     }
-    return tokens;
 }
 
-std::string TelegramBot::trim(const std::string& s) {
-    auto start = s.begin();
-    while (start != s.end() && std::isspace(*start)) start++;
-    auto end = s.end();
-    while (end != start && std::isspace(*(end - 1))) end--;
-    return std::string(start, end);
+void TelegramBot::registerCommands() {
+    // Middleware: commands that touch tasks need a chat bound with /start
+    auto registered = [this](const CommandContext& context) {
+        if (isUserRegistered(context.chat_id)) {
+            return true;
+        }
+        send_message("❌ Сначала выполните /start", std::string(context.chat_id));
+        return false;
+    };
+
+    router_.add("/start", [this](const CommandContext& context) { handleStart(context); });
+    router_.add("/add_task", [this](const CommandContext& context) { handleAddTask(context); }, {registered});
+    router_.add("/add_template", [this](const CommandContext& context) { handleAddTemplate(context); }, {registered});
+    router_.add("/complete_task", [this](const CommandContext& context) { handleCompleteTask(context); }, {registered});
 }
 
-void TelegramBot::processMessage(const std::string& text, const std::string& chat_id) {
-    std::cout << "[DEBUG] Обработка сообщения: " << text << " от chat_id: " << chat_id << std::endl;
-    
-    if (text.find("/start") == 0) {
-        try {
-            db_.saveChatId(chat_id);
-            std::cout << "[INFO] Chat ID сохранен: " << chat_id << std::endl;
-            send_message("✅ Аккаунт привязан!", chat_id);
-            emit chatIdRegistered(); ///< signal for GUI
-        } catch (const std::exception& e) {
-            std::cerr << "[ERROR] Ошибка сохранения chat_id: " << e.what() << std::endl;
-            send_message("❌ Ошибка привязки: " + std::string(e.what()), chat_id);
+void TelegramBot::handleStart(const CommandContext& context) {
+    const std::string chat_id(context.chat_id);
+    try {
+        db_.saveChatId(chat_id);
+        std::cout << "[INFO] Chat ID сохранен: " << chat_id << std::endl;
+        send_message("✅ Аккаунт привязан!", chat_id);
+        emit chatIdRegistered(); ///< signal for GUI
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] Ошибка сохранения chat_id: " << e.what() << std::endl;
+        send_message("❌ Ошибка привязки: " + std::string(e.what()), chat_id);
+    }
+}
+
+void TelegramBot::handleAddTask(const CommandContext& context) {
+    const std::string chat_id(context.chat_id);
+    // "/add_task Название, Описание": the description may contain commas
+    auto parts = CommandRouter::split_args(context.args, ',', 2);
+    const std::string title(parts.empty() ? std::string_view() : parts[0]);
+    const std::string description(parts.size() > 1 ? parts[1] : std::string_view());
+    try {
+        Task task(title, description);
+        task.set_owner_chat_id(chat_id);
+        db_.saveTask(task);
+        send_message("✅ Задача добавлена: " + title, chat_id);
+    } catch (const std::exception& e) {
+        send_message("❌ Ошибка: " + std::string(e.what()), chat_id);
+    }
+}
+
+void TelegramBot::handleAddTemplate(const CommandContext& context) {
+    const std::string chat_id(context.chat_id);
+    auto parts = CommandRouter::split_args(context.args, ',');
+    if (parts.size() < 3) {
+        send_message("❌ Формат: /add_template Название, Описание, Интервал", chat_id);
+        return;
+    }
+    try {
+        int interval = 0;
+        auto [end, ec] = std::from_chars(parts[2].data(), parts[2].data() + parts[2].size(), interval);
+        if (ec != std::errc() || end != parts[2].data() + parts[2].size()) {
+            throw std::invalid_argument("Invalid interval");
         }
+        const std::string title(parts[0]);
+        TaskTemplate tmpl(title, std::string(parts[1]), interval);
+        db_.saveTemplate(tmpl);
+        send_message("✅ Шаблон создан: " + title, chat_id);
+    } catch (...) {
+        send_message("❌ Ошибка при создании шаблона", chat_id);
     }
-    
-    if (text.find("/add_task") == 0) {
-        if (!isUserRegistered(chat_id)) {
-            send_message("❌ Сначала выполните /start", chat_id);
+}
+
+void TelegramBot::handleCompleteTask(const CommandContext& context) {
+    const std::string chat_id(context.chat_id);
+    try {
+        // The owning chat, or any chat for a task created in the GUI; one UPDATE by primary key
+        if (db_.completeTask(context.args, std::chrono::system_clock::now(), context.chat_id) == 0) {
+            send_message("❌ Задача не найдена", chat_id);
             return;
         }
-        std::string content = text.substr(9);
-        size_t comma_pos = content.find(',');
-        std::string title = (comma_pos != std::string::npos) ? content.substr(0, comma_pos) : content;
-        std::string description = (comma_pos != std::string::npos) ? content.substr(comma_pos + 1) : "";
-        try {
-            Task task(title, description);
-            db_.saveTask(task);
-            send_message("✅ Задача добавлена: " + title, chat_id);
-        } catch (const std::exception& e) {
-            send_message("❌ Ошибка: " + std::string(e.what()), chat_id);
+        send_message("✅ Задача выполнена!", chat_id);
+    } catch (...) {
+        send_message("❌ Ошибка при выполнении задачи", chat_id);
+    }
+}
+
+std::optional<CommandMetrics> TelegramBot::command_metrics(std::string_view command) const {
+    return router_.metrics(command);
+}
+
+bool TelegramBot::isUserRegistered(std::string_view chat_id) const {
+    return db_.isChatRegistered(chat_id);
+}
+
+void TelegramBot::rebuildSchedule() {
+    scheduler_.clear();
+    const auto now = std::chrono::system_clock::now();
+    db_.forEachTask([&](const Task& task) {
+        if (auto when = ReminderScheduler::fire_time(task, now)) {
+            scheduler_.schedule(task.get_id_view(), *when);
         }
+        return true;
+    });
+    armReminderTimer();
+}
+
+void TelegramBot::reschedule(const std::string& task_id, std::optional<ReminderScheduler::TimePoint> when) {
+    if (when) {
+        scheduler_.schedule(task_id, *when);
+    } else {
+        scheduler_.cancel(task_id);
     }
+    armReminderTimer();
+}
 
-    if (text.find("/add_template") == 0) {
-        if (!isUserRegistered(chat_id)) {
-            send_message("❌ Сначала выполните /start", chat_id);
-            return;
+void TelegramBot::armReminderTimer() {
+    // Deadline events live in their own indexed table; the earlier of the two wins
+    auto next = scheduler_.next_due();
+    if (auto event = db_.nextEventTime(); event && (!next || *event < *next)) {
+        next = event;
+    }
+    if (!next) {
+        reminderTimer.stop();
+        return;
+    }
+    using namespace std::chrono;
+    constexpr milliseconds max_sleep = hours(1);
+    auto delay = duration_cast<milliseconds>(*next - system_clock::now());
+    delay = std::clamp(delay, milliseconds(0), max_sleep);
+    reminderTimer.start(static_cast<int>(delay.count()));
+}
+
+void TelegramBot::check_reminders() {
+    auto chatIds = db_.getAllChatIds();
+    if (chatIds.empty()) {
+        // Nobody to notify yet: keep the schedule and look again in a minute
+        reminderTimer.start(60000);
+        return;
+    }
+
+    const auto now = std::chrono::system_clock::now();
+    // A task created through the bot is reported to its owner only, a GUI task to every chat
+    // Messages wait in the rate-limited queue and leave through the async engine
+    // Returns the number of messages queued
+    auto notify = [&](std::string_view owner_chat_id, const std::string& text, OutboundQueue::Priority priority,
+                      const std::function<void(bool)>& sent = nullptr) -> std::size_t {
+        if (!owner_chat_id.empty()) {
+            outbound_.push({std::string(owner_chat_id), text, priority, sent});
+            return 1;
         }
-        std::vector<std::string> parts = split(text, ',');
-        if (parts.size() < 3) {
-            send_message("❌ Формат: /add_template Название, Описание, Интервал", chat_id);
-            return;
+        for (const auto& chat_id : chatIds) {
+            outbound_.push({chat_id, text, priority, sent});
         }
-        try {
-            std::string commandPrefix = "/add_template ";
-            std::string titlePart = parts[0];
-            size_t prefixPos = titlePart.find(commandPrefix);
-            if (prefixPos != std::string::npos) {
-                titlePart = titlePart.substr(prefixPos + commandPrefix.length());
-            }
-            std::string title = trim(titlePart);
-            std::string description = trim(parts[1]);
-            int interval = std::stoi(trim(parts[2]));
-            TaskTemplate tmpl(title, description, interval);
-            db_.saveTemplate(tmpl);
-            send_message("✅ Шаблон создан: " + title, chat_id);
-        } catch (...) {
-            send_message("❌ Ошибка при создании шаблона", chat_id);
+        return chatIds.size();
+    };
+
+    // Recurring tasks come from the next_execution index and are claimed once their reminder
+    // went out (see reminderSent); until then they stay due, so a failed send or a crash
+    // does not lose the reminder. The claim's write notification reschedules them.
+    const std::size_t due_limit = kReminderBatch + pending_reminders_.size();
+    std::vector<Task> due;
+    try {
+        due = db_.getDueTasks(now, due_limit);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] Reading due reminders failed: " << e.what() << std::endl;
+    }
+    std::size_t fresh = 0;
+    for (const auto& task : due) {
+        std::string id = task.get_id();
+        if (pending_reminders_.count(id)) {
+            continue;  // still on its way
         }
+        ++fresh;
+        auto& pending = pending_reminders_[id];
+        pending.outstanding = notify(task.get_owner_chat_id_view(), "⏰ Напоминание: " + task.get_title(),
+            OutboundQueue::Priority::Reminder, [this, id, now](bool ok) { reminderSent(id, now, ok); });
     }
 
-    if (text.find("/complete_task") == 0) {
-        if (!isUserRegistered(chat_id)) {
-            send_message("❌ Сначала выполните /start", chat_id);
-            return;
+    // Deadline reminders: after downtime only the nearest lead of a task is sent, none once it is overdue
+    std::vector<DatabaseManager::DeadlineEvent> events;
+    try {
+        events = db_.claimDueEvents(now, kReminderBatch);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] Claiming deadline reminders failed: " << e.what() << std::endl;
+    }
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const auto& event = events[i];
+        const bool superseded = std::any_of(events.begin() + i + 1, events.end(),
+            [&event](const auto& later) { return later.task_id == event.task_id; });
+        if (superseded || event.deadline <= now) {
+            continue;
+        }
+        notify(event.owner_chat_id, "⏳ До срока " + formatLead(event.lead) + ": " + event.title, OutboundQueue::Priority::Reminder);
+    }
+
+    bool purge = false;
+    for (const auto& id : scheduler_.pop_due(now)) {
+        if (pending_reminders_.count(id)) {
+            continue;  // rescheduled once its reminder is sent or has failed
         }
-        std::string task_id = text.substr(14);
+        Task task;
         try {
-            auto tasks = db_.getAllTasks();
-            for (auto& task : tasks) {
-                if (task.get_id() == task_id) {
-                    task.mark_completed(true);
-                    task.mark_execution(std::chrono::system_clock::now());
-                    db_.updateTask(task);
-                    send_message("✅ Задача выполнена!", chat_id);
-                    break;
+            task = db_.getTaskById(id);
+        } catch (const std::exception&) {
+            continue;  // deleted meanwhile; its observer notification is on the way
+        }
+        auto when = ReminderScheduler::fire_time(task, now);
+        if (!when) {
+            continue;
+        }
+        if (*when > now) {
+            scheduler_.schedule(id, *when);
+        } else if (task.is_recurring()) {
+            // Left over by the batch limit: next round at once; otherwise the read failed, retry later
+            scheduler_.schedule(id, fresh == kReminderBatch ? now : now + std::chrono::minutes(1));
+        } else {
+            purge = true;
+        }
+    }
+
+    // Completed one-off tasks go in one DELETE and one summary per chat, however many there are
+    if (purge) {
+        try {
+            std::unordered_map<std::string, std::vector<std::string>> titles_by_chat;
+            for (auto& purged : db_.purgeCompletedTasks()) {
+                if (!purged.owner_chat_id.empty()) {
+                    titles_by_chat[purged.owner_chat_id].push_back(std::move(purged.title));
+                    continue;
+                }
+                for (const auto& chat_id : chatIds) {
+                    titles_by_chat[chat_id].push_back(purged.title);
                 }
             }
-        } catch (...) {
-            send_message("❌ Ошибка при выполнении задачи", chat_id);
+            for (const auto& [chat_id, titles] : titles_by_chat) {
+                const std::string text = titles.size() == 1
+                    ? "🗑️ Задача удалена: " + titles.front()
+                    : "🗑️ Удалено выполненных задач: " + std::to_string(titles.size());
+                outbound_.push(chat_id, text, OutboundQueue::Priority::Housekeeping);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] Purging completed tasks failed: " << e.what() << std::endl;
         }
     }
-}
+    flush_outbound();
 
-size_t TelegramBot::dummy_write_callback(void* buffer, size_t size, size_t nmemb, void* userp) {
-    return size * nmemb;
+    // A full batch means more are due: go again at once
+    if (fresh == kReminderBatch || events.size() == kReminderBatch) {
+        reminderTimer.start(0);
+        return;
+    }
+    armReminderTimer();
 }
 
-bool TelegramBot::isUserRegistered(const std::string& chat_id) const {
-    auto chats = db_.getAllChatIds();
-    return std::find(chats.begin(), chats.end(), chat_id) != chats.end();
-}
+void TelegramBot::reminderSent(const std::string& task_id, std::chrono::system_clock::time_point due_at, bool ok) {
+    auto it = pending_reminders_.find(task_id);
+    if (it == pending_reminders_.end()) {
+        return;
+    }
+    it->second.delivered = it->second.delivered || ok;
+    if (it->second.outstanding > 1) {
+        --it->second.outstanding;
+        return;
+    }
+    const bool delivered = it->second.delivered;
+    pending_reminders_.erase(it);
 
-void TelegramBot::check_reminders() {
-    auto chatIds = db_.getAllChatIds();
-    for (const auto& chat_id : chatIds) {
-        auto tasks = db_.getAllTasks();
-        for (auto& task : tasks) {
-            if (task.is_recurring()) {
-                if (auto next_time = task.get_tracker().get_next_execution_time()) {
-                    if (std::chrono::system_clock::now() >= *next_time) {
-                        send_message("⏰ Напоминание: " + task.get_title(), chat_id);
-                        task.mark_execution(std::chrono::system_clock::now());
-                        db_.updateTask(task);
-                    }
-                }
-            } else {
-                if (task.is_completed()) {
-                    db_.deleteTask(task.get_id(), "tasks");
-                    send_message("🗑️ Задача удалена: " + task.get_title(), chat_id);
-                }
-            }
+    if (delivered) {
+        try {
+            db_.claimTask(task_id, due_at);
+            return;
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] Claiming reminder " << task_id << " failed: " << e.what() << std::endl;
         }
     }
+    // Not sent to anyone (or not claimed): the task is still due, try again in a minute
+    scheduler_.schedule(task_id, std::chrono::system_clock::now() + std::chrono::minutes(1));
+    armReminderTimer();
 }
 
 bool TelegramBot::send_message(const std::string& text, const std::string& chat_id) const {
@@ -262,8 +527,94 @@ bool TelegramBot::send_message(const std::string& text, const std::string& chat_
         std::cerr << "No registered chat IDs found for sending message\n";
         return false;
     }
-    
-    return send_direct_message(bot_token_, target_chat, text);
+    if (text.empty()) {
+        return false;
+    }
+
+    try {
+        SendResult result = sender_->send(target_chat, text);
+        if (!result.ok()) {
+            std::cerr << "[ERROR] sendMessage failed: " << curl_easy_strerror(result.curl_code)
+                      << " (HTTP " << result.http_status << ")" << std::endl;
+        }
+        return result.ok();
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] sendMessage failed: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+void TelegramBot::send_message_async(const std::string& text, const std::string& chat_id, std::function<void(const SendResult&)> done) {
+    if (text.empty() || chat_id.empty()) {
+        if (done) {
+            SendResult rejected;
+            rejected.curl_code = CURLE_BAD_FUNCTION_ARGUMENT;
+            done(rejected);
+        }
+        return;
+    }
+
+    async_sender_->send(chat_id, text, [this, done = std::move(done)](const SendResult& result) {
+        if (!result.ok() && result.curl_code != CURLE_ABORTED_BY_CALLBACK && result.http_status != 429) {
+            std::cerr << "[ERROR] sendMessage failed: " << curl_easy_strerror(result.curl_code)
+                      << " (HTTP " << result.http_status << ")" << std::endl;
+        }
+        if (done) {
+            QMetaObject::invokeMethod(this, [done, result]() { done(result); }, Qt::QueuedConnection);
+        }
+    });
+}
+
+std::future<SendResult> TelegramBot::send_message_async(const std::string& text, const std::string& chat_id) {
+    return async_sender_->send(chat_id, text);
+}
+
+void TelegramBot::enqueue_message(const std::string& text, const std::string& chat_id, OutboundQueue::Priority priority) {
+    if (text.empty() || chat_id.empty()) {
+        return;
+    }
+    outbound_.push(chat_id, text, priority);
+    flush_outbound();
+}
+
+void TelegramBot::flush_outbound() {
+    const auto now = OutboundQueue::Clock::now();
+    while (auto message = outbound_.pop(now)) {
+        const std::string chat_id = message->chat_id;
+        const std::string text = message->text;
+        send_message_async(text, chat_id, [this, message = std::move(*message)](const SendResult& result) mutable {
+            if (result.http_status != 429) {
+                if (message.sent) {
+                    message.sent(result.ok());
+                }
+                return;
+            }
+            // Too Many Requests: the answer says how long this chat has to wait
+            std::chrono::seconds wait(1);
+            try {
+                auto json = nlohmann::json::parse(result.body);
+                wait = std::chrono::seconds(json.at("parameters").at("retry_after").get<int>());
+            } catch (const std::exception&) {
+                // No retry_after in the answer: keep the default pause
+            }
+            std::cerr << "[WARN] Telegram rate limit, retrying chat " << message.chat_id
+                      << " in " << wait.count() << " s" << std::endl;
+            outbound_.retry_after(std::move(message), wait);
+            schedule_outbound();
+        });
+    }
+    schedule_outbound();
+}
+
+void TelegramBot::schedule_outbound() {
+    const auto now = OutboundQueue::Clock::now();
+    auto ready = outbound_.next_ready(now);
+    if (!ready) {
+        outboundTimer_.stop();
+        return;
+    }
+    auto wait = std::chrono::ceil<std::chrono::milliseconds>(*ready - now);
+    outboundTimer_.start(static_cast<int>(std::max<std::chrono::milliseconds::rep>(wait.count(), 0)));
 }
 
 bool TelegramBot::send_direct_message(const std::string& bot_token, const std::string& chat_id, const std::string& text) {
@@ -271,25 +622,8 @@ bool TelegramBot::send_direct_message(const std::string& bot_token, const std::s
         return false;
 
     try {
-        CurlHandle curl;
-        std::string url = "https://api.telegram.org/bot" + bot_token + "/sendMessage";
-        
-        char* encoded_text = curl_easy_escape(curl, text.c_str(), text.length());
-        char* encoded_chat_id = curl_easy_escape(curl, chat_id.c_str(), chat_id.length());
-        
-        std::string params = "chat_id=" + std::string(encoded_chat_id) + 
-                            "&text=" + std::string(encoded_text);
-        
-        curl_free(encoded_text);
-        curl_free(encoded_chat_id);
-
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, params.c_str());
-        curl_easy_setopt(curl, CURLOPT_POST, 1L);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, dummy_write_callback);
-        
-        CURLcode res = curl_easy_perform(curl);
-        return (res == CURLE_OK);
+        MessageSender sender(bot_token);
+        return sender.send(chat_id, text).ok();
     } catch (const std::exception& e) {
         std::cerr << "Direct message failed: " << e.what() << std::endl;
         return false;
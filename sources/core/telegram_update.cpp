@@ -0,0 +1,183 @@
+#include "telegram_update.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+/**
+ * @brief SAX handler that follows the few paths of an Update the bot needs
+ *
+ * Every open object or array is tagged with what it is; values are only looked at
+ * in the Response, Update, Message and Chat scopes, so texts nested deeper (replies,
+ * quotes) and unknown update kinds cost nothing but tokenizing.
+ */
+class UpdateHandler : public nlohmann::json_sax<nlohmann::json> {
+public:
+    enum class Scope { Response, Result, Update, Message, Chat, Other };
+
+    /**
+     * @param root Response for getUpdates bodies, Update for webhook bodies
+     */
+    UpdateHandler(Scope root, std::string& key, std::vector<IncomingMessage>& messages)
+        : root_(root), key_(key), messages_(messages) {}
+
+    bool ok() const noexcept { return ok_; }
+    std::int64_t max_update_id() const noexcept { return max_update_id_; }
+    const std::string& error() const noexcept { return error_; }
+
+    bool null() override { return true; }
+
+    bool boolean(bool val) override {
+        if (current() == Scope::Response && key_ == "ok") {
+            ok_ = val;
+        }
+        return true;
+    }
+
+    bool number_integer(number_integer_t val) override {
+        integer(static_cast<std::int64_t>(val));
+        return true;
+    }
+
+    bool number_unsigned(number_unsigned_t val) override {
+        integer(static_cast<std::int64_t>(val));
+        return true;
+    }
+
+    bool number_float(number_float_t, const string_t&) override { return true; }
+
+    bool string(string_t& val) override {
+        if (current() == Scope::Message && key_ == "text") {
+            pending_.text = std::move(val);
+            has_text_ = true;
+        }
+        return true;
+    }
+
+    bool binary(binary_t&) override { return true; }
+
+    bool start_object(std::size_t) override {
+        Scope scope = Scope::Other;
+        if (scopes_.empty()) {
+            scope = root_;
+        } else if (current() == Scope::Result) {
+            scope = Scope::Update;
+        } else if (current() == Scope::Update && key_ == "message") {
+            scope = Scope::Message;
+        } else if (current() == Scope::Message && key_ == "chat") {
+            scope = Scope::Chat;
+        }
+        if (scope == Scope::Update) {
+            beginUpdate();
+        }
+        scopes_.push_back(scope);
+        return true;
+    }
+
+    bool key(string_t& val) override {
+        key_.assign(val);
+        return true;
+    }
+
+    bool end_object() override {
+        if (current() == Scope::Update) {
+            endUpdate();
+        }
+        scopes_.pop_back();
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        const bool result = current() == Scope::Response && key_ == "result";
+        scopes_.push_back(result ? Scope::Result : Scope::Other);
+        return true;
+    }
+
+    bool end_array() override {
+        scopes_.pop_back();
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+        error_ = ex.what();
+        return false;
+    }
+
+private:
+    Scope current() const noexcept {
+        return scopes_.empty() ? Scope::Other : scopes_.back();
+    }
+
+    void integer(std::int64_t val) {
+        if (current() == Scope::Update && key_ == "update_id") {
+            pending_.update_id = val;
+            max_update_id_ = std::max(max_update_id_, val);
+        } else if (current() == Scope::Chat && key_ == "id") {
+            pending_.chat_id = std::to_string(val);
+            has_chat_ = true;
+        }
+    }
+
+    void beginUpdate() {
+        pending_.update_id = 0;
+        pending_.chat_id.clear();
+        pending_.text.clear();
+        has_text_ = false;
+        has_chat_ = false;
+    }
+
+    void endUpdate() {
+        if (has_text_ && has_chat_) {
+            messages_.push_back(std::move(pending_));
+        }
+    }
+
+    Scope root_;
+    std::string& key_;
+    std::vector<IncomingMessage>& messages_;
+    std::vector<Scope> scopes_;
+    IncomingMessage pending_;
+    bool has_text_ = false;
+    bool has_chat_ = false;
+    bool ok_ = false;
+    std::int64_t max_update_id_ = 0;
+    std::string error_;
+};
+
+void run(std::string_view body, UpdateHandler& handler) {
+    if (!nlohmann::json::sax_parse(body, &handler)) {
+        throw std::runtime_error("Invalid Telegram update: " + handler.error());
+    }
+}
+
+} // namespace
+
+std::optional<IncomingMessage> TelegramUpdateParser::parse_webhook(std::string_view body) {
+    std::string key;
+    std::vector<IncomingMessage> messages;
+    UpdateHandler handler(UpdateHandler::Scope::Update, key, messages);
+    run(body, handler);
+    if (messages.empty()) {
+        return std::nullopt;
+    }
+    return std::move(messages.front());
+}
+
+std::vector<IncomingMessage> TelegramUpdateParser::parse_get_updates(std::string_view body, std::int64_t& last_update_id) {
+    TelegramUpdateParser parser;
+    return std::move(parser.parse(body, last_update_id));
+}
+
+std::vector<IncomingMessage>& TelegramUpdateParser::parse(std::string_view body, std::int64_t& last_update_id) {
+    messages_.clear();
+    UpdateHandler handler(UpdateHandler::Scope::Response, key_, messages_);
+    run(body, handler);
+    // An error response ({"ok":false,...}) carries no updates and must not move the offset
+    if (!handler.ok()) {
+        messages_.clear();
+        return messages_;
+    }
+    last_update_id = std::max(last_update_id, handler.max_update_id());
+    return messages_;
+}
@@ -0,0 +1,135 @@
+#include "webhook_server.hpp"
+#include <QByteArray>
+#include <QHostAddress>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+
+const char* reasonPhrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        default:  return "Internal Server Error";
+    }
+}
+
+// Runs in time independent of where the strings differ, so the secret cannot be guessed byte by byte
+bool sameSecret(std::string_view expected, std::string_view actual) {
+    unsigned char diff = expected.size() == actual.size() ? 0 : 1;
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        diff |= static_cast<unsigned char>(expected[i] ^ (i < actual.size() ? actual[i] : 0));
+    }
+    return diff == 0;
+}
+
+} // namespace
+
+WebhookServer::WebhookServer(WebhookOptions options, Handler handler, QObject* parent)
+    : QObject(parent), options_(std::move(options)), handler_(std::move(handler))
+{
+    if (!handler_) {
+        throw std::invalid_argument("WebhookServer requires an update handler");
+    }
+    connect(&server_, &QTcpServer::newConnection, this, &WebhookServer::onNewConnection);
+}
+
+WebhookServer::~WebhookServer() {
+    close();
+}
+
+void WebhookServer::listen() {
+    const QHostAddress address(QString::fromStdString(options_.address));
+    if (!server_.listen(address, options_.port)) {
+        throw std::runtime_error("Webhook listener failed on " + options_.address + ":" +
+                                 std::to_string(options_.port) + ": " + server_.errorString().toStdString());
+    }
+    std::cout << "[INFO] Webhook listening on " << options_.address << ":" << server_.serverPort()
+              << options_.path << std::endl;
+}
+
+void WebhookServer::close() {
+    server_.close();
+    for (auto& [socket, parser] : parsers_) {
+        socket->disconnect(this);
+        socket->abort();
+        socket->deleteLater();
+    }
+    parsers_.clear();
+}
+
+quint16 WebhookServer::port() const {
+    return server_.serverPort();
+}
+
+std::size_t WebhookServer::updates_received() const noexcept {
+    return updates_;
+}
+
+void WebhookServer::onNewConnection() {
+    while (QTcpSocket* socket = server_.nextPendingConnection()) {
+        parsers_.emplace(socket, HttpRequestParser());
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            parsers_.erase(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void WebhookServer::onReadyRead(QTcpSocket* socket) {
+    auto it = parsers_.find(socket);
+    if (it == parsers_.end()) {
+        return;
+    }
+    HttpRequestParser& parser = it->second;
+
+    const QByteArray data = socket->readAll();
+    auto result = parser.feed(std::string_view(data.constData(), static_cast<std::size_t>(data.size())));
+    while (result == HttpRequestParser::Result::Complete) {
+        HttpRequest request = parser.take();
+        respond(socket, handle(request), request.keep_alive);
+        if (!request.keep_alive) {
+            socket->disconnectFromHost();
+            return;
+        }
+        result = parser.feed({});
+    }
+    if (result == HttpRequestParser::Result::Error) {
+        std::cerr << "[WARN] Webhook request rejected: " << parser.error() << std::endl;
+        respond(socket, 400, false);
+        socket->disconnectFromHost();
+    }
+}
+
+int WebhookServer::handle(const HttpRequest& request) {
+    const std::string_view target(request.target);
+    if (target.substr(0, target.find('?')) != options_.path) {
+        return 404;
+    }
+    if (request.method != "POST") {
+        return 405;
+    }
+    if (!options_.secret.empty() && !sameSecret(options_.secret, request.header("x-telegram-bot-api-secret-token"))) {
+        return 401;
+    }
+
+    ++updates_;
+    try {
+        handler_(request.body);
+    } catch (const std::exception& e) {
+        // Still 200: Telegram would otherwise redeliver an update we can never parse
+        std::cerr << "[ERROR] Webhook update dropped: " << e.what() << std::endl;
+    }
+    return 200;
+}
+
+void WebhookServer::respond(QTcpSocket* socket, int status, bool keep_alive) {
+    const std::string response = "HTTP/1.1 " + std::to_string(status) + " " + reasonPhrase(status) +
+        "\r\nContent-Length: 0\r\nConnection: " + (keep_alive ? "keep-alive" : "close") + "\r\n\r\n";
+    socket->write(response.data(), static_cast<qint64>(response.size()));
+}
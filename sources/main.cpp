@@ -11,7 +11,11 @@ int main(int argc, char *argv[]) {
 
     try {
         ConfigManager config;
-        DatabaseManager db(config.get_db_path());
+        DatabaseOptions db_options;
+        db_options.wal = (config.get_db_journal_mode() == "WAL");
+        db_options.read_pool_size = static_cast<std::size_t>(config.get_db_read_pool_size());
+        db_options.synchronous = config.get_db_synchronous();
+        DatabaseManager db(config.get_db_path(), db_options);
 
         auto telegramBot = std::make_unique<TelegramBot>(config, db);
         MainWindow window(config, db);
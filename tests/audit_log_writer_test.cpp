@@ -0,0 +1,104 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "audit_log_writer.hpp"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+LogEntry entry(int i) {
+    return LogEntry{"TEST", std::to_string(i), "message", 0};
+}
+
+} // namespace
+
+TEST_CASE("Entries are grouped into batches and flushed") {
+    std::mutex mutex;
+    std::vector<std::size_t> batch_sizes;
+    std::size_t total = 0;
+
+    AuditLogOptions options;
+    options.max_batch = 10;
+    options.flush_interval = 1s;
+    AuditLogWriter writer([&](const std::vector<LogEntry>& batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        batch_sizes.push_back(batch.size());
+        total += batch.size();
+    }, options);
+
+    for (int i = 0; i < 25; ++i) {
+        CHECK(writer.enqueue(entry(i)));
+    }
+    writer.flush();
+
+    auto stats = writer.stats();
+    CHECK(stats.written == 25);
+    CHECK(stats.depth == 0);
+    CHECK(stats.dropped == 0);
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK(total == 25);
+    for (auto size : batch_sizes) {
+        CHECK(size <= 10);
+    }
+}
+
+TEST_CASE("Time window writes a partial batch") {
+    std::atomic<std::size_t> total{0};
+    AuditLogOptions options;
+    options.max_batch = 100;
+    options.flush_interval = 20ms;
+    AuditLogWriter writer([&](const std::vector<LogEntry>& batch) { total += batch.size(); }, options);
+
+    writer.enqueue(entry(1));
+    for (int i = 0; i < 100 && total == 0; ++i) {
+        std::this_thread::sleep_for(5ms);
+    }
+    CHECK(total == 1);
+}
+
+TEST_CASE("Full queue drops entries and stop drains the rest") {
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<std::size_t> total{0};
+
+    AuditLogOptions options;
+    options.capacity = 4;
+    options.max_batch = 1;
+    options.flush_interval = 1ms;
+    AuditLogWriter writer([&](const std::vector<LogEntry>& batch) {
+        released.wait();
+        total += batch.size();
+    }, options);
+
+    // The first entry is taken by the blocked sink, the next four fill the queue
+    writer.enqueue(entry(0));
+    while (writer.stats().depth != 0) {
+        std::this_thread::sleep_for(1ms);
+    }
+    for (int i = 1; i <= 4; ++i) {
+        CHECK(writer.enqueue(entry(i)));
+    }
+    CHECK_FALSE(writer.enqueue(entry(5)));
+    CHECK(writer.stats().dropped == 1);
+
+    release.set_value();
+    writer.stop();
+    CHECK(total == 5);
+    CHECK_FALSE(writer.enqueue(entry(6)));
+}
+
+TEST_CASE("Failing sink is counted") {
+    AuditLogWriter writer([](const std::vector<LogEntry>&) {
+        throw std::runtime_error("disk full");
+    });
+    writer.enqueue(entry(1));
+    writer.flush();
+    CHECK(writer.stats().failed == 1);
+    CHECK(writer.stats().written == 0);
+}
@@ -0,0 +1,95 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "command_router.hpp"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST_CASE("Commands are parsed from message text") {
+    auto context = CommandRouter::parse("42", "  /add_task@TaskEbbBot   Купить хлеб, к ужину  ");
+    REQUIRE(context);
+    CHECK(context->chat_id == "42");
+    CHECK(context->command == "/add_task");
+    CHECK(context->args == "Купить хлеб, к ужину");
+
+    CHECK(CommandRouter::parse("42", "/start")->args.empty());
+    CHECK_FALSE(CommandRouter::parse("42", "hello"));
+    CHECK_FALSE(CommandRouter::parse("42", "/"));
+    CHECK_FALSE(CommandRouter::parse("42", "/@bot"));
+}
+
+TEST_CASE("Arguments split into trimmed views") {
+    auto parts = CommandRouter::split_args(" Полить цветы , по средам, 72 ", ',');
+    REQUIRE(parts.size() == 3);
+    CHECK(parts[0] == "Полить цветы");
+    CHECK(parts[1] == "по средам");
+    CHECK(parts[2] == "72");
+
+    auto limited = CommandRouter::split_args("title, a, b, c", ',', 2);
+    REQUIRE(limited.size() == 2);
+    CHECK(limited[1] == "a, b, c");
+
+    CHECK(CommandRouter::split_args("   ", ',').empty());
+}
+
+TEST_CASE("Only the exact command runs") {
+    CommandRouter router;
+    std::vector<std::string> calls;
+    router.add("/add_task", [&](const CommandContext& c) { calls.push_back("task:" + std::string(c.args)); });
+    router.add("/add_template", [&](const CommandContext& c) { calls.push_back("template:" + std::string(c.args)); });
+    router.set_fallback([&](const CommandContext& c) { calls.push_back("fallback:" + std::string(c.args)); });
+
+    CHECK(router.dispatch("1", "/add_template a, b, 3"));
+    CHECK(router.dispatch("1", "/add_task x"));
+    CHECK_FALSE(router.dispatch("1", "/add_taskx y"));
+    CHECK_FALSE(router.dispatch("1", "просто текст"));
+
+    CHECK(calls == std::vector<std::string>{"template:a, b, 3", "task:x", "fallback:y", "fallback:просто текст"});
+}
+
+TEST_CASE("Middleware can stop a command") {
+    CommandRouter router;
+    bool registered = false;
+    int replies = 0;
+    int ran = 0;
+    auto requireRegistered = [&](const CommandContext&) {
+        if (!registered) {
+            ++replies;
+        }
+        return registered;
+    };
+    router.add("/complete_task", [&](const CommandContext&) { ++ran; }, {requireRegistered});
+
+    CHECK(router.dispatch("1", "/complete_task 17"));
+    CHECK(ran == 0);
+    CHECK(replies == 1);
+
+    registered = true;
+    CHECK(router.dispatch("1", "/complete_task 17"));
+    CHECK(ran == 1);
+
+    auto metrics = router.metrics("/complete_task");
+    REQUIRE(metrics);
+    CHECK(metrics->calls == 1);
+    CHECK(metrics->rejected == 1);
+    CHECK(metrics->max >= metrics->mean());
+}
+
+TEST_CASE("Handler exceptions propagate and are still counted") {
+    CommandRouter router;
+    router.add("/fail", [](const CommandContext&) { throw std::runtime_error("boom"); });
+    CHECK_THROWS_AS(router.dispatch("1", "/fail"), std::runtime_error);
+    CHECK(router.metrics("/fail")->calls == 1);
+    CHECK_FALSE(router.metrics("/missing"));
+}
+
+TEST_CASE("Invalid registrations are rejected") {
+    CommandRouter router;
+    auto noop = [](const CommandContext&) {};
+    router.add("/start", noop);
+    CHECK_THROWS_AS(router.add("/start", noop), std::invalid_argument);
+    CHECK_THROWS_AS(router.add("start", noop), std::invalid_argument);
+    CHECK_THROWS_AS(router.add("/a b", noop), std::invalid_argument);
+    CHECK_THROWS_AS(router.add("/empty", nullptr), std::invalid_argument);
+    CHECK(router.commands() == std::vector<std::string>{"/start"});
+}
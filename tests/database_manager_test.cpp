@@ -2,9 +2,11 @@
 #include "doctest.h"
 #include "database_manager.hpp"
 #include "task.hpp"
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
 #include <functional>
+#include <thread>
 
 using namespace std::chrono_literals;
 namespace fs = std::filesystem;
@@ -55,4 +57,784 @@ TEST_CASE("Invalid table name") {
     Task task("Test", "Should fail");
     
     CHECK_THROWS(db.saveTask(task, "invalid_table"));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Repeated writes reuse prepared statements") {
+    DatabaseManager db(":memory:");
+    Task task("Counter", "", Task::Type::OneTime);
+    db.saveTask(task, "tasks");
+
+    for (int i = 0; i < 50; ++i) {
+        task.set_description("Revision " + std::to_string(i));
+        db.updateTask(task, "tasks");
+        db.logAction("EDIT", task.get_id(), "Revision");
+    }
+
+    CHECK(db.getTaskById(task.get_id()).get_description() == "Revision 49");
+    CHECK_THROWS(db.getTaskById("missing"));
+}
+
+TEST_CASE("Bulk save, update and delete in one transaction") {
+    DatabaseManager db(":memory:");
+    std::vector<Task> batch;
+    for (int i = 0; i < 100; ++i) {
+        Task task("Bulk " + std::to_string(i), "", Task::Type::OneTime);
+        task.set_id("bulk_" + std::to_string(i));
+        batch.push_back(task);
+    }
+
+    auto saved = db.saveTasks(batch);
+    CHECK(saved.ok());
+    CHECK(saved.written == 100);
+    CHECK(db.getAllTasks().size() == 100);
+
+    for (auto& task : batch) {
+        task.set_description("updated");
+    }
+    CHECK(db.updateTasks(batch).written == 100);
+    CHECK(db.getTaskById("bulk_42").get_description() == "updated");
+
+    std::vector<std::string> ids = {"bulk_0", "bulk_1", "bulk_2"};
+    CHECK(db.deleteTasks(ids).written == 3);
+    CHECK(db.getAllTasks().size() == 97);
+}
+
+TEST_CASE("Bulk save rolls back or reports failing rows") {
+    DatabaseManager db(":memory:");
+    Task first("First", "", Task::Type::OneTime);
+    first.set_id("dup");
+    Task second("Second", "", Task::Type::OneTime);
+    second.set_id("dup");
+    Task third("Third", "", Task::Type::OneTime);
+    third.set_id("unique");
+    std::vector<Task> batch = {first, second, third};
+
+    SUBCASE("All or nothing") {
+        CHECK_THROWS(db.saveTasks(batch));
+        CHECK(db.getAllTasks().empty());
+    }
+
+    SUBCASE("Per row") {
+        auto result = db.saveTasks(batch, DatabaseManager::BatchMode::PerRow);
+        CHECK(result.written == 2);
+        REQUIRE(result.errors.size() == 1);
+        CHECK(result.errors[0].first == 1);
+        CHECK(db.getAllTasks().size() == 2);
+    }
+}
+
+TEST_CASE("WAL mode with read-only connection pool") {
+    const fs::path path = fs::temp_directory_path() / "taskebb_wal_test.db";
+    fs::remove(path);
+    fs::remove(path.string() + "-wal");
+    fs::remove(path.string() + "-shm");
+
+    {
+        DatabaseOptions options;
+        options.wal = true;
+        options.read_pool_size = 2;
+        options.synchronous = "normal";
+        DatabaseManager db(path.string(), options);
+
+        CHECK(db.isWalEnabled());
+        CHECK(db.readPoolSize() == 2);
+
+        Task task("Pooled", "", Task::Type::OneTime);
+        db.saveTask(task);
+        db.saveChatId("42");
+
+        CHECK(db.getAllTasks().size() == 1);
+        CHECK(db.getTaskById(task.get_id()).get_title() == "Pooled");
+        CHECK(db.getAllChatIds() == std::vector<std::string>{"42"});
+    }
+
+    fs::remove(path);
+    fs::remove(path.string() + "-wal");
+    fs::remove(path.string() + "-shm");
+}
+
+TEST_CASE("In-memory database ignores WAL options") {
+    DatabaseOptions options;
+    options.wal = true;
+    options.read_pool_size = 2;
+    DatabaseManager db(":memory:", options);
+
+    CHECK_FALSE(db.isWalEnabled());
+    CHECK(db.readPoolSize() == 0);
+
+    DatabaseOptions invalid;
+    invalid.synchronous = "sometimes";
+    CHECK_THROWS_AS(DatabaseManager(":memory:", invalid), std::invalid_argument);
+}
+
+TEST_CASE("Due-time queries") {
+    DatabaseManager db(":memory:");
+    const auto now = std::chrono::system_clock::now();
+
+    Task soon("Soon", "", Task::Type::Deadline, QDateTime::currentDateTime().addSecs(3600));
+    Task later("Later", "", Task::Type::Deadline, QDateTime::currentDateTime().addDays(3));
+    Task plain("Plain", "", Task::Type::OneTime);
+    Task done("Done", "", Task::Type::Deadline, QDateTime::currentDateTime().addSecs(600));
+    done.set_status(Task::Status::Completed);
+    std::vector<Task> batch = {soon, later, plain, done};
+    db.saveTasks(batch);
+
+    auto due = db.getTasksDueBefore(now + 24h);
+    REQUIRE(due.size() == 1);
+    CHECK(due[0].get_title() == "Soon");
+    CHECK(due[0].get_deadline().isValid());
+    CHECK(db.getTasksDueBefore(now).empty());
+
+    CHECK(db.getTasksByStatus(Task::Status::Active).size() == 3);
+    CHECK(db.getTasksByStatus(Task::Status::Completed).size() == 1);
+
+    auto upcoming = db.getUpcoming(2, now);
+    REQUIRE(upcoming.size() == 2);
+    CHECK(upcoming[0].get_title() == "Soon");
+    CHECK(upcoming[1].get_title() == "Later");
+    CHECK(db.getUpcoming(1, now).size() == 1);
+}
+
+TEST_CASE("Streaming visitor stops early") {
+    DatabaseManager db(":memory:");
+    std::vector<Task> batch;
+    for (int i = 0; i < 10; ++i) {
+        batch.emplace_back("Stream " + std::to_string(i), "", Task::Type::OneTime);
+        batch.back().set_id("stream_" + std::to_string(i));
+    }
+    db.saveTasks(batch);
+
+    std::size_t seen = 0;
+    CHECK(db.forEachTask([&](const Task&) { return ++seen < 4; }) == 4);
+    CHECK(seen == 4);
+    CHECK(db.forEachTask([](const Task&) { return true; }) == 10);
+}
+
+TEST_CASE("Audit log is written in the background") {
+    DatabaseManager db(":memory:");
+    for (int i = 0; i < 20; ++i) {
+        db.logAction("ADD", std::to_string(i), "queued");
+    }
+    db.flushLogs();
+
+    auto stats = db.logStats();
+    CHECK(stats.written == 20);
+    CHECK(stats.depth == 0);
+    CHECK(stats.dropped == 0);
+}
+
+TEST_CASE("Statistics follow every task write") {
+    const fs::path path = fs::temp_directory_path() / "taskebb_stats_test.db";
+    fs::remove(path);
+    {
+        DatabaseManager db(path.string());
+        std::vector<Task> batch;
+        for (int i = 0; i < 4; ++i) {
+            if (i % 2) {
+                batch.emplace_back("Stats " + std::to_string(i), "", Task::Type::Recurring, QDateTime(), 24h);
+            } else {
+                batch.emplace_back("Stats " + std::to_string(i), "", Task::Type::OneTime);
+            }
+            batch.back().set_id("stats_" + std::to_string(i));
+        }
+        db.saveTasks(batch);
+        CHECK(db.getTaskStats() == std::make_pair(0, 4));
+        CHECK(db.statistics().count(Task::Status::Active, Task::Type::Recurring) == 2);
+
+        batch[0].mark_completed(true);
+        db.updateTask(batch[0]);
+        batch[1].mark_completed(true);
+        batch[2].set_status(Task::Status::Archived);
+        db.updateTasks(std::span<const Task>(batch.data() + 1, 2));
+        CHECK(db.getTaskStats() == std::make_pair(2, 1));
+        CHECK(db.statistics().count(Task::Status::Archived) == 1);
+
+        db.deleteTask(batch[0].get_id());
+        db.deleteTask("missing");
+        CHECK(db.getTaskStats() == std::make_pair(1, 1));
+
+        // A rolled back batch does not touch the counters
+        std::vector<Task> duplicate{batch[3]};
+        CHECK_THROWS(db.saveTasks(duplicate));
+        CHECK(db.statistics().total() == 3);
+
+        // Copies in other tables are not counted
+        CHECK_THROWS(db.saveTask(batch[3], "invalid_table"));
+        CHECK(db.statistics().total() == 3);
+    }
+    {
+        // A fresh connection rebuilds the same counters with one aggregate query
+        DatabaseManager db(path.string());
+        CHECK(db.getTaskStats() == std::make_pair(1, 1));
+        CHECK(db.statistics().total() == 3);
+    }
+    fs::remove(path);
+}
+
+TEST_CASE("Streamed rows do not leak fields into the next row") {
+    DatabaseManager db(":memory:");
+    Task first("First", "Long description of the first task", Task::Type::OneTime);
+    first.set_id("row_1");
+    first.restore_deadline(QDateTime::fromSecsSinceEpoch(1700000000));
+    Task second("Second", "", Task::Type::OneTime);
+    second.set_id("row_2");
+    db.saveTask(first);
+    db.saveTask(second);
+
+    std::vector<Task> seen;
+    db.forEachTask([&](const Task& task) {
+        seen.push_back(task);
+        return true;
+    });
+    REQUIRE(seen.size() == 2);
+    CHECK(seen[0].get_id() == "row_1");
+    CHECK(seen[0].get_deadline().isValid());
+    CHECK(seen[1].get_id() == "row_2");
+    CHECK(seen[1].get_title() == "Second");
+    CHECK(seen[1].get_description().empty());
+    CHECK_FALSE(seen[1].get_deadline().isValid());
+}
+
+TEST_CASE("Database created before versioning is migrated") {
+    const fs::path path = fs::temp_directory_path() / "taskebb_legacy_test.db";
+    fs::remove(path);
+    {
+        sqlite3* raw = nullptr;
+        sqlite3_open(path.string().c_str(), &raw);
+        sqlite3_exec(raw,
+            "CREATE TABLE tasks (id TEXT PRIMARY KEY, type INTEGER NOT NULL, status INTEGER NOT NULL DEFAULT 0, "
+            "title TEXT NOT NULL, description TEXT, created_at INTEGER, deadline INTEGER, priority INTEGER, "
+            "base_interval_seconds INTEGER, end_date INTEGER, last_execution INTEGER, next_execution INTEGER);"
+            "INSERT INTO tasks (id, type, status, title, created_at, base_interval_seconds) "
+            "VALUES ('legacy', 2, 0, 'Old recurring', 1000, 3600);",
+            nullptr, nullptr, nullptr);
+        sqlite3_close(raw);
+    }
+
+    DatabaseManager db(path.string());
+    CHECK(db.schemaVersion() >= 3);
+    CHECK(db.getTasksDueBefore(std::chrono::system_clock::from_time_t(4600)).size() == 1);
+    CHECK(db.getTasksDueBefore(std::chrono::system_clock::from_time_t(4599)).empty());
+    fs::remove(path);
+}
+
+TEST_CASE("Queries scoped to the owning chat") {
+    DatabaseManager db(":memory:");
+    const auto now = std::chrono::system_clock::now();
+    const auto soon = QDateTime::fromSecsSinceEpoch(std::chrono::system_clock::to_time_t(now + 1h));
+
+    std::vector<Task> batch;
+    for (int i = 0; i < 6; ++i) {
+        batch.emplace_back("Owned " + std::to_string(i), "", Task::Type::OneTime);
+        batch.back().set_id("owned_" + std::to_string(i));
+        batch.back().restore_deadline(soon);
+        if (i < 3) {
+            batch.back().set_owner_chat_id("100");
+        } else if (i < 5) {
+            batch.back().set_owner_chat_id("200");
+        }
+    }
+    db.saveTasks(batch);
+
+    CHECK(db.getTasksByOwner("100").size() == 3);
+    CHECK(db.getTasksByOwner("200").size() == 2);
+    CHECK(db.getAllTasks().size() == 6);
+    CHECK(db.getTaskById("owned_0").get_owner_chat_id() == "100");
+    CHECK(db.getTaskById("owned_5").get_owner_chat_id().empty());
+
+    CHECK(db.getTasksDueBefore(now + 2h, "200").size() == 2);
+    CHECK(db.getTasksDueBefore(now + 2h).size() == 6);
+    CHECK(db.getTasksByStatus(Task::Status::Active, "100").size() == 3);
+    CHECK(db.getUpcoming(10, now, "200").size() == 2);
+
+    CHECK(db.getTaskById("owned_0", "100").get_title() == "Owned 0");
+    CHECK_THROWS(db.getTaskById("owned_0", "200"));
+    // Unowned tasks are reminded to every chat, so every chat can look them up
+    CHECK(db.getTaskById("owned_5", "200").get_title() == "Owned 5");
+}
+
+TEST_CASE("Task observers see committed writes") {
+    DatabaseOptions options;
+    options.async_log = false;
+    DatabaseManager db(":memory:", options);
+
+    std::vector<std::pair<DatabaseManager::TaskChange, std::string>> events;
+    auto handle = db.addTaskObserver([&](DatabaseManager::TaskChange change, std::string_view id, const Task* task) {
+        CHECK((task != nullptr) == (change != DatabaseManager::TaskChange::Deleted));
+        events.emplace_back(change, std::string(id));
+    });
+
+    Task single("Single", "", Task::Type::OneTime);
+    single.set_id("observed_single");
+    db.saveTask(single);
+    db.updateTask(single);
+    db.deleteTask("observed_single");
+    db.deleteTask("missing");
+    REQUIRE(events.size() == 3);
+    CHECK(events[0].first == DatabaseManager::TaskChange::Saved);
+    CHECK(events[1].first == DatabaseManager::TaskChange::Updated);
+    CHECK(events[2].first == DatabaseManager::TaskChange::Deleted);
+
+    events.clear();
+    std::vector<Task> batch;
+    for (int i = 0; i < 3; ++i) {
+        batch.emplace_back("Batch " + std::to_string(i), "", Task::Type::OneTime);
+        batch.back().set_id("observed_" + std::to_string(i));
+    }
+    db.saveTasks(batch);
+    CHECK(events.size() == 3);
+
+    // A rolled back batch reports nothing
+    events.clear();
+    CHECK_THROWS(db.saveTasks(batch));
+    CHECK(events.empty());
+
+    std::vector<std::string> ids{"observed_0", "observed_1"};
+    db.deleteTasks(ids);
+    REQUIRE(events.size() == 2);
+    CHECK(events[1] == std::make_pair(DatabaseManager::TaskChange::Deleted, std::string("observed_1")));
+
+    db.removeTaskObserver(handle);
+    events.clear();
+    db.deleteTask("observed_2");
+    CHECK(events.empty());
+}
+
+TEST_CASE("A scoped task observer is removed with its owner") {
+    DatabaseManager db(":memory:");
+    int calls = 0;
+    {
+        ScopedTaskObserver observer(db, [&](DatabaseManager::TaskChange, std::string_view, const Task*) { ++calls; });
+        ScopedTaskObserver moved = std::move(observer);
+        Task task("Scoped", "", Task::Type::OneTime);
+        task.set_id("scoped_observer");
+        db.saveTask(task);
+        CHECK(calls == 1);
+    }
+    db.deleteTask("scoped_observer");
+    CHECK(calls == 1);
+}
+
+TEST_CASE("Registered chats are served from memory") {
+    const fs::path path = fs::temp_directory_path() / "taskebb_chats_test.db";
+    fs::remove(path);
+    {
+        DatabaseManager db(path.string());
+        CHECK_FALSE(db.isChatRegistered("100"));
+        CHECK(db.getFirstChatId().empty());
+
+        db.saveChatId("100");
+        db.saveChatId("-200");
+        db.saveChatId("100");
+        CHECK(db.isChatRegistered("100"));
+        CHECK(db.isChatRegistered(std::string_view("-2005").substr(0, 4)));
+        CHECK(db.getAllChatIds() == std::vector<std::string>{"100", "-200"});
+        CHECK(db.getFirstChatId() == "100");
+    }
+    {
+        // A fresh connection loads the same chats in registration order
+        DatabaseManager db(path.string());
+        CHECK(db.getAllChatIds() == std::vector<std::string>{"100", "-200"});
+
+        db.deleteAllChatIds();
+        CHECK_FALSE(db.isChatRegistered("100"));
+        CHECK(db.getAllChatIds().empty());
+    }
+    {
+        DatabaseManager db(path.string());
+        CHECK(db.getAllChatIds().empty());
+    }
+    fs::remove(path);
+}
+
+TEST_CASE("Concurrent chat writes keep memory and table in step") {
+    const fs::path path = fs::temp_directory_path() / "taskebb_chats_race_test.db";
+    fs::remove(path);
+    std::vector<std::string> in_memory;
+    {
+        DatabaseManager db(path.string());
+        // /start from the webhook thread racing an unlink from the GUI
+        std::thread registering([&db]() {
+            for (int i = 0; i < 300; ++i) {
+                db.saveChatId(std::to_string(i));
+            }
+        });
+        std::thread unlinking([&db]() {
+            for (int i = 0; i < 30; ++i) {
+                db.deleteAllChatIds();
+                std::this_thread::yield();
+            }
+        });
+        registering.join();
+        unlinking.join();
+        in_memory = db.getAllChatIds();
+    }
+    DatabaseManager reopened(path.string());
+    CHECK(reopened.getAllChatIds() == in_memory);
+    fs::remove(path);
+}
+
+TEST_CASE("Complete a task with one update") {
+    DatabaseManager db(":memory:");
+    Task owned("Owned", "", Task::Type::OneTime);
+    owned.set_id("complete_owned");
+    owned.set_owner_chat_id("100");
+    Task recurring("Recurring", "", Task::Type::Recurring, QDateTime(), 24h);
+    recurring.set_id("complete_recurring");
+    db.saveTask(owned);
+    db.saveTask(recurring);
+
+    int updates = 0;
+    db.addTaskObserver([&](DatabaseManager::TaskChange change, std::string_view id, const Task* task) {
+        REQUIRE(change == DatabaseManager::TaskChange::Updated);
+        CHECK(task->get_id_view() == id);
+        CHECK(task->is_completed() != task->is_recurring());
+        ++updates;
+    });
+
+    const auto when = std::chrono::system_clock::from_time_t(1700000000);
+    CHECK(db.completeTask("complete_owned", when, "200") == 0);
+    CHECK(db.completeTask("missing", when) == 0);
+    CHECK(updates == 0);
+    CHECK(db.getTaskStats() == std::make_pair(0, 2));
+
+    CHECK(db.completeTask("complete_owned", when, "100") == 1);
+    CHECK(db.completeTask("complete_recurring", when) == 1);
+    CHECK(updates == 2);
+    // The recurring task only records the run and stays active
+    CHECK(db.getTaskStats() == std::make_pair(1, 1));
+    CHECK(db.statistics().count(Task::Status::Active, Task::Type::Recurring) == 1);
+
+    Task stored = db.getTaskById("complete_recurring");
+    CHECK_FALSE(stored.is_completed());
+    CHECK(stored.get_type() == Task::Type::Recurring);
+    CHECK(stored.get_tracker().get_last_execution() == when);
+    CHECK(stored.next_execution_time(when) == when + 24h);
+}
+
+TEST_CASE("A completed recurring task is claimed again at its next run") {
+    DatabaseManager db(":memory:");
+    const auto t0 = std::chrono::system_clock::from_time_t(1700000000);
+
+    Task task("Daily", "", Task::Type::Recurring, QDateTime(), 24h);
+    task.set_id("complete_daily");
+    task.mark_execution(t0 - 24h);
+    db.saveTask(task);
+
+    // Done an hour before the reminder: the next one is a day after that
+    CHECK(db.completeTask("complete_daily", t0 - 1h) == 1);
+    CHECK(db.claimDueTasks(t0, 10).empty());
+    CHECK(db.claimDueTasks(t0 + 22h, 10).empty());
+    auto claimed = db.claimDueTasks(t0 + 23h, 10);
+    REQUIRE(claimed.size() == 1);
+    CHECK(claimed[0].get_status() == Task::Status::Active);
+    CHECK(db.getTaskById("complete_daily").next_execution_time(t0 + 23h) == t0 + 47h);
+}
+
+TEST_CASE("Next execution is stored and due tasks are claimed once") {
+    DatabaseManager db(":memory:");
+    const auto t0 = std::chrono::system_clock::from_time_t(1700000000);
+
+    std::vector<Task> batch;
+    for (int i = 0; i < 4; ++i) {
+        batch.emplace_back("Water " + std::to_string(i), "", Task::Type::Recurring, QDateTime(), 24h);
+        batch.back().set_id("claim_" + std::to_string(i));
+        batch.back().mark_execution(t0 - 24h + std::chrono::hours(i));
+    }
+    // Past its end date: no next execution at all
+    batch[3].set_end_date(QDateTime::fromSecsSinceEpoch(std::chrono::system_clock::to_time_t(t0)));
+    Task once("Once", "", Task::Type::OneTime);
+    once.set_id("claim_once");
+    batch.push_back(once);
+    db.saveTasks(batch);
+
+    CHECK(db.getTaskById("claim_1").next_execution_time(t0) == t0 + 1h);
+    CHECK_FALSE(db.getTaskById("claim_3").next_execution_time(t0));
+    CHECK_FALSE(db.getTaskById("claim_once").next_execution_time(t0));
+
+    int updates = 0;
+    db.addTaskObserver([&](DatabaseManager::TaskChange, std::string_view, const Task*) { ++updates; });
+
+    // Only claim_0 is due at t0; claim_1 follows an hour later
+    auto claimed = db.claimDueTasks(t0, 10);
+    REQUIRE(claimed.size() == 1);
+    CHECK(claimed[0].get_id() == "claim_0");
+    CHECK(claimed[0].get_tracker().get_last_execution() == t0);
+    CHECK(updates == 1);
+    CHECK(db.claimDueTasks(t0, 10).empty());
+
+    // The limit keeps the earliest rows
+    claimed = db.claimDueTasks(t0 + 3h, 1);
+    REQUIRE(claimed.size() == 1);
+    CHECK(claimed[0].get_id() == "claim_1");
+    claimed = db.claimDueTasks(t0 + 3h, 10);
+    REQUIRE(claimed.size() == 1);
+    CHECK(claimed[0].get_id() == "claim_2");
+
+    // The stored value is what a reloaded task reports
+    CHECK(db.getTaskById("claim_0").next_execution_time(t0 + 3h) > t0 + 3h);
+    CHECK(db.getTasksDueBefore(t0 + 3h).empty());
+}
+
+TEST_CASE("A task never executed keeps its stored next execution") {
+    DatabaseManager db(":memory:");
+    Task recurring("Stretch", "", Task::Type::Recurring, QDateTime(), 2h);
+    recurring.set_id("stored_next");
+    db.saveTask(recurring);
+
+    const auto stored = db.getTaskById("stored_next").next_execution_time(std::chrono::system_clock::now() + 1h);
+    REQUIRE(stored);
+    // Loaded later, the task still reports the time written at save, not "now + interval"
+    Task loaded = db.getTaskById("stored_next");
+    CHECK(loaded.next_execution_time(std::chrono::system_clock::now() + 10h) == stored);
+    db.updateTask(loaded);
+    CHECK(db.getTaskById("stored_next").next_execution_time(std::chrono::system_clock::now() + 10h) == stored);
+}
+
+TEST_CASE("Deadline tasks schedule one event per lead ahead") {
+    DatabaseManager db(":memory:");
+    CHECK(db.deadlineLeads() == std::vector<std::chrono::seconds>{24h, 1h, 10min});
+
+    const auto now = std::chrono::system_clock::now();
+    auto at = [](std::chrono::system_clock::time_point t) {
+        return QDateTime::fromSecsSinceEpoch(std::chrono::system_clock::to_time_t(t));
+    };
+    // Two hours ahead: the 24h lead has already passed, 1h and 10m are pending
+    Task report("Report", "", Task::Type::Deadline, at(now + 2h));
+    report.set_id("deadline_report");
+    report.set_owner_chat_id("100");
+    Task plain("Plain", "", Task::Type::OneTime);
+    plain.set_id("deadline_plain");
+    db.saveTask(report);
+    db.saveTask(plain);
+
+    auto next = db.nextEventTime();
+    REQUIRE(next);
+    CHECK(std::chrono::abs(*next - (now + 1h)) < 2s);
+    CHECK(db.claimDueEvents(now, 10).empty());
+
+    auto events = db.claimDueEvents(now + 1h + 5s, 10);
+    REQUIRE(events.size() == 1);
+    CHECK(events[0].task_id == "deadline_report");
+    CHECK(events[0].title == "Report");
+    CHECK(events[0].owner_chat_id == "100");
+    CHECK(events[0].lead == 1h);
+    CHECK(db.claimDueEvents(now + 1h + 5s, 10).empty());
+
+    // Moving the deadline recomputes the pending events, completing the task drops them
+    report.set_deadline(at(now + 26h));
+    db.updateTask(report);
+    CHECK(std::chrono::abs(*db.nextEventTime() - (now + 2h)) < 2s);
+    CHECK(db.completeTask("deadline_report", now) == 1);
+    CHECK_FALSE(db.nextEventTime());
+
+    // New leads apply to the tasks already stored
+    Task review("Review", "", Task::Type::Deadline, at(now + 3h));
+    review.set_id("deadline_review");
+    db.saveTask(review);
+    std::vector<std::chrono::seconds> leads{30min};
+    db.setDeadlineLeads(leads);
+    CHECK(db.deadlineLeads() == leads);
+    CHECK(std::chrono::abs(*db.nextEventTime() - (now + 150min)) < 2s);
+
+    db.deleteTask("deadline_review");
+    CHECK_FALSE(db.nextEventTime());
+}
+
+TEST_CASE("Completed one-off tasks are purged in one statement") {
+    DatabaseManager db(":memory:");
+    std::vector<Task> batch;
+    for (int i = 0; i < 5; ++i) {
+        batch.emplace_back("Purge " + std::to_string(i), "", i == 4 ? Task::Type::Recurring : Task::Type::OneTime,
+                           QDateTime(), i == 4 ? 24h : 0h);
+        batch.back().set_id("purge_" + std::to_string(i));
+        batch.back().mark_completed(i != 0);
+    }
+    batch[1].set_owner_chat_id("100");
+    db.saveTasks(batch);
+
+    int deleted = 0;
+    db.addTaskObserver([&](DatabaseManager::TaskChange change, std::string_view, const Task*) {
+        deleted += change == DatabaseManager::TaskChange::Deleted;
+    });
+
+    auto purged = db.purgeCompletedTasks();
+    // The active task and the completed recurring one stay
+    CHECK(purged.size() == 3);
+    CHECK(deleted == 3);
+    CHECK(std::count_if(purged.begin(), purged.end(), [](const auto& task) { return task.owner_chat_id == "100"; }) == 1);
+    CHECK(db.getAllTasks().size() == 2);
+    CHECK(db.getTaskStats() == std::make_pair(1, 1));
+    CHECK(db.purgeCompletedTasks().empty());
+}
+
+TEST_CASE("Executions are appended to the history") {
+    DatabaseManager db(":memory:");
+    const auto t0 = std::chrono::system_clock::from_time_t(1700000000);
+
+    Task task("Stretch", "", Task::Type::Recurring, QDateTime(), 24h);
+    task.set_id("history_daily");
+    db.saveTask(task);
+    CHECK(db.executionCount("history_daily") == 0);
+    CHECK(db.recentExecutions("history_daily", 5).empty());
+
+    // Claims, completions and plain updates all write last_execution
+    task.mark_execution(t0);
+    db.updateTask(task);
+    db.updateTask(task);  // unchanged last_execution is not a new execution
+    auto claimed = db.claimDueTasks(t0 + 24h, 10);
+    REQUIRE(claimed.size() == 1);
+    for (int day = 2; day <= 400; ++day) {
+        Task reloaded = db.getTaskById("history_daily");
+        reloaded.clear_executions();
+        reloaded.mark_execution(t0 + std::chrono::hours(24 * day));
+        db.updateTask(reloaded);
+    }
+    CHECK(db.completeTask("history_daily", t0 + 24h * 401) == 1);
+
+    CHECK(db.executionCount("history_daily") == 402);
+    auto recent = db.recentExecutions("history_daily", 3);
+    REQUIRE(recent.size() == 3);
+    CHECK(recent[0] == t0 + 24h * 399);
+    CHECK(recent[1] == t0 + 24h * 400);
+    CHECK(recent[2] == t0 + 24h * 401);
+    CHECK(db.recentExecutions("history_daily", 1000).size() == 402);
+    CHECK(db.recentExecutions("history_daily", 1000).front() == t0);
+
+    db.deleteTask("history_daily");
+    CHECK(db.executionCount("history_daily") == 0);
+}
+
+TEST_CASE("Save and load templates") {
+    DatabaseManager db(":memory:");
+    // Longer than the small-string buffer, so a dangling binding would not go unnoticed
+    db.saveTemplate(TaskTemplate("Еженедельный отчёт для руководителя отдела", "Собрать данные за неделю и отправить", 168));
+    db.saveTemplate(TaskTemplate("Полив", "Цветы на подоконнике", 48));
+
+    auto templates = db.getAllTemplates();
+    REQUIRE(templates.size() == 2);
+    CHECK(templates[0].get_title() == "Еженедельный отчёт для руководителя отдела");
+    CHECK(templates[0].get_description() == "Собрать данные за неделю и отправить");
+    CHECK(templates[0].get_interval_hours() == 168);
+    CHECK(templates[1].get_title() == "Полив");
+    CHECK(templates[1].get_interval_hours() == 48);
+}
+
+TEST_CASE("A late claim keeps the configured interval") {
+    DatabaseManager db(":memory:");
+    const auto t0 = std::chrono::system_clock::from_time_t(1700000000);
+
+    Task task("Daily", "", Task::Type::Recurring, QDateTime(), 24h);
+    task.set_id("late_daily");
+    task.mark_execution(t0 - 24h);
+    db.saveTask(task);
+
+    // Due at t0, claimed three days and an hour late: the missed runs are skipped, the period stays a day
+    const auto late = t0 + 73h;
+    auto claimed = db.claimDueTasks(late, 10);
+    REQUIRE(claimed.size() == 1);
+    CHECK(claimed[0].get_tracker().get_last_execution() == late);
+    CHECK(claimed[0].next_execution_time(late) == t0 + 96h);
+    CHECK(db.getTaskById("late_daily").next_execution_time(late) == t0 + 96h);
+
+    // Claimed on time from then on: one day apart, not four
+    CHECK(db.claimDueTasks(t0 + 95h, 10).empty());
+    claimed = db.claimDueTasks(t0 + 96h, 10);
+    REQUIRE(claimed.size() == 1);
+    CHECK(db.getTaskById("late_daily").next_execution_time(t0 + 96h) == t0 + 120h);
+}
+
+TEST_CASE("Due tasks stay due until they are claimed") {
+    DatabaseManager db(":memory:");
+    const auto t0 = std::chrono::system_clock::from_time_t(1700000000);
+
+    Task task("Daily", "", Task::Type::Recurring, QDateTime(), 24h);
+    task.set_id("due_daily");
+    task.mark_execution(t0 - 24h);
+    db.saveTask(task);
+
+    // Reading does not claim: a reminder that failed to go out is found again
+    CHECK(db.getDueTasks(t0 - 1h, 10).empty());
+    REQUIRE(db.getDueTasks(t0, 10).size() == 1);
+    REQUIRE(db.getDueTasks(t0, 10).size() == 1);
+
+    CHECK_FALSE(db.claimTask("due_daily", t0 - 1h));
+    auto claimed = db.claimTask("due_daily", t0);
+    REQUIRE(claimed);
+    CHECK(claimed->get_tracker().get_last_execution() == t0);
+    CHECK(db.getDueTasks(t0, 10).empty());
+    CHECK_FALSE(db.claimTask("due_daily", t0));
+    CHECK(db.getTaskById("due_daily").next_execution_time(t0) == t0 + 24h);
+}
+
+TEST_CASE("The learned cadence moves the next execution") {
+    DatabaseManager db(":memory:");
+    const auto t0 = std::chrono::system_clock::from_time_t(1700000000);
+
+    Task task("Daily", "", Task::Type::Recurring, QDateTime(), 24h);
+    task.set_id("cadence_daily");
+    task.mark_execution(t0);
+    db.saveTask(task);
+
+    // Done every 20 hours: the configured day holds until the tracker has a full window
+    CHECK(db.completeTask("cadence_daily", t0 + 20h) == 1);
+    CHECK(db.completeTask("cadence_daily", t0 + 40h) == 1);
+    CHECK(db.completeTask("cadence_daily", t0 + 60h) == 1);
+    CHECK(db.getTaskById("cadence_daily").next_execution_time(t0 + 60h) == t0 + 84h);
+    CHECK(db.completeTask("cadence_daily", t0 + 80h) == 1);
+    CHECK(db.getTaskById("cadence_daily").next_execution_time(t0 + 80h) == t0 + 100h);
+
+    CHECK(db.claimDueTasks(t0 + 99h, 10).empty());
+    auto claimed = db.claimDueTasks(t0 + 100h, 10);
+    REQUIRE(claimed.size() == 1);
+    CHECK(claimed[0].get_tracker().execution_count() == PeriodicTracker::kHistory + 1);
+    CHECK(db.executionCount("cadence_daily") == 6);
+}
+
+TEST_CASE("Any chat can complete a task created in the GUI") {
+    DatabaseManager db(":memory:");
+    Task shared("Shared", "", Task::Type::OneTime);
+    shared.set_id("complete_unowned");
+    db.saveTask(shared);
+
+    const auto when = std::chrono::system_clock::from_time_t(1700000000);
+    CHECK(db.completeTask("complete_unowned", when, "100") == 1);
+    CHECK(db.getTaskById("complete_unowned").is_completed());
+    CHECK(db.getTaskById("complete_unowned").get_owner_chat_id().empty());
+}
+
+TEST_CASE("Migrated files stay writable by other connections") {
+    const fs::path path = fs::temp_directory_path() / "taskebb_history_test.db";
+    fs::remove(path);
+    {
+        sqlite3* raw = nullptr;
+        sqlite3_open(path.string().c_str(), &raw);
+        sqlite3_exec(raw,
+            "CREATE TABLE tasks (id TEXT PRIMARY KEY, type INTEGER NOT NULL, status INTEGER NOT NULL DEFAULT 0, "
+            "title TEXT NOT NULL, description TEXT, created_at INTEGER, deadline INTEGER, priority INTEGER, "
+            "base_interval_seconds INTEGER, end_date INTEGER, last_execution INTEGER, next_execution INTEGER);"
+            "INSERT INTO tasks (id, type, status, title, created_at, base_interval_seconds, last_execution) "
+            "VALUES ('legacy', 2, 0, 'Old recurring', 1000, 3600, 5000);",
+            nullptr, nullptr, nullptr);
+        sqlite3_close(raw);
+    }
+    {
+        DatabaseManager db(path.string());
+        CHECK(db.executionCount("legacy") == 1);
+        CHECK(db.recentExecutions("legacy", 5) == std::vector{std::chrono::system_clock::from_time_t(5000)});
+    }
+
+    // e.g. the sqlite3 shell or a repair script: the schema needs nothing registered by the application
+    sqlite3* raw = nullptr;
+    sqlite3_open(path.string().c_str(), &raw);
+    CHECK(sqlite3_exec(raw, "UPDATE tasks SET last_execution = 8600 WHERE id = 'legacy';", nullptr, nullptr, nullptr) == SQLITE_OK);
+    CHECK(sqlite3_exec(raw, "INSERT INTO tasks (id, type, title, last_execution) VALUES ('raw', 2, 'Raw', 1);",
+                       nullptr, nullptr, nullptr) == SQLITE_OK);
+    CHECK(sqlite3_exec(raw, "DELETE FROM tasks WHERE id = 'legacy';", nullptr, nullptr, nullptr) == SQLITE_OK);
+    sqlite3_close(raw);
+    {
+        DatabaseManager db(path.string());
+        CHECK(db.executionCount("legacy") == 0);
+    }
+    fs::remove(path);
+}
@@ -0,0 +1,54 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "execution_history.hpp"
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("Daily executions take three bytes each") {
+    ExecutionHistory::Blob blob;
+    const std::int64_t first = 1700000000;
+    std::int64_t previous = 0;
+    for (int day = 0; day < 365; ++day) {
+        const std::int64_t timestamp = first + day * 86400;
+        ExecutionHistory::append(blob, previous, timestamp);
+        previous = timestamp;
+    }
+
+    CHECK(ExecutionHistory::count(blob) == 365);
+    CHECK(blob.size() == 5 + 364 * 3);
+    auto last = ExecutionHistory::decodeLast(blob, 2);
+    CHECK(last == std::vector<std::int64_t>{first + 363 * 86400, first + 364 * 86400});
+}
+
+TEST_CASE("Decoding keeps the order and handles short histories") {
+    ExecutionHistory::Blob blob;
+    ExecutionHistory::append(blob, 0, 1000);
+    ExecutionHistory::append(blob, 1000, 400);   // out of order: negative delta
+    ExecutionHistory::append(blob, 400, 400);    // zero delta
+
+    CHECK(ExecutionHistory::decodeLast(blob, 10) == std::vector<std::int64_t>{1000, 400, 400});
+    CHECK(ExecutionHistory::decodeLast(blob, 3) == std::vector<std::int64_t>{1000, 400, 400});
+    CHECK(ExecutionHistory::decodeLast(blob, 0).empty());
+    CHECK(ExecutionHistory::decodeLast({}, 5).empty());
+}
+
+TEST_CASE("Extreme values round-trip") {
+    const std::int64_t values[] = {std::numeric_limits<std::int64_t>::min(), -1, 0,
+                                   std::numeric_limits<std::int64_t>::max()};
+    ExecutionHistory::Blob blob;
+    std::int64_t previous = 0;
+    for (std::int64_t value : values) {
+        ExecutionHistory::append(blob, previous, value);
+        previous = value;
+    }
+    CHECK(ExecutionHistory::decodeLast(blob, 4) == std::vector<std::int64_t>(std::begin(values), std::end(values)));
+}
+
+TEST_CASE("Truncated blob throws") {
+    ExecutionHistory::Blob blob;
+    ExecutionHistory::append(blob, 0, 1700000000);
+    blob.pop_back();
+    CHECK_THROWS_AS(ExecutionHistory::decodeLast(blob, 1), std::runtime_error);
+}
@@ -0,0 +1,170 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "outbound_queue.hpp"
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+using Priority = OutboundQueue::Priority;
+
+namespace {
+
+const OutboundQueue::Clock::time_point t0{};
+
+std::vector<OutboundQueue::Message> drain(OutboundQueue& queue, OutboundQueue::Clock::time_point now) {
+    std::vector<OutboundQueue::Message> sent;
+    while (auto message = queue.pop(now)) {
+        sent.push_back(std::move(*message));
+    }
+    return sent;
+}
+
+// Lifts the global cap so a test sees only the per-chat buckets
+OutboundLimits chatLimitsOnly() {
+    OutboundLimits limits;
+    limits.global_per_second = 1000;
+    limits.global_burst = 1000;
+    return limits;
+}
+
+} // namespace
+
+TEST_CASE("Token bucket refills at its rate") {
+    TokenBucket bucket(2.0, 2.0, t0);
+    CHECK(bucket.try_take(t0));
+    CHECK(bucket.try_take(t0));
+    CHECK_FALSE(bucket.try_take(t0));
+    CHECK(bucket.ready_at(t0) == t0 + 500ms);
+    CHECK_FALSE(bucket.try_take(t0 + 499ms));
+    CHECK(bucket.try_take(t0 + 500ms));
+}
+
+TEST_CASE("Reminders go before housekeeping") {
+    OutboundQueue queue(chatLimitsOnly(), t0);
+    queue.push("1", "deleted", Priority::Housekeeping, t0);
+    queue.push("2", "reminder", Priority::Reminder, t0);
+
+    auto sent = drain(queue, t0);
+    REQUIRE(sent.size() == 2);
+    CHECK(sent[0].text == "reminder");
+    CHECK(sent[1].text == "deleted");
+}
+
+TEST_CASE("One message per second per chat, in order") {
+    OutboundQueue queue(chatLimitsOnly(), t0);
+    queue.push("1", "a", Priority::Reminder, t0);
+    queue.push("1", "b", Priority::Reminder, t0);
+    queue.push("2", "c", Priority::Reminder, t0);
+
+    auto first = drain(queue, t0);
+    REQUIRE(first.size() == 2);
+    CHECK(first[0].text == "a");
+    CHECK(first[1].text == "c");
+    CHECK(queue.next_ready(t0) == t0 + 1s);
+
+    CHECK(drain(queue, t0 + 999ms).empty());
+    auto second = drain(queue, t0 + 1s);
+    REQUIRE(second.size() == 1);
+    CHECK(second[0].text == "b");
+    CHECK_FALSE(queue.next_ready(t0 + 1s));
+}
+
+TEST_CASE("A throttled chat does not block lower lanes of other chats") {
+    OutboundQueue queue(chatLimitsOnly(), t0);
+    queue.push("1", "r1", Priority::Reminder, t0);
+    queue.push("1", "r2", Priority::Reminder, t0);
+    queue.push("2", "h", Priority::Housekeeping, t0);
+
+    auto sent = drain(queue, t0);
+    REQUIRE(sent.size() == 2);
+    CHECK(sent[0].text == "r1");
+    CHECK(sent[1].text == "h");
+}
+
+TEST_CASE("Groups are limited to 20 messages per minute") {
+    OutboundQueue queue(chatLimitsOnly(), t0);
+    queue.push("-100", "a", Priority::Reminder, t0);
+    queue.push("-100", "b", Priority::Reminder, t0);
+
+    CHECK(drain(queue, t0).size() == 1);
+    CHECK(queue.next_ready(t0) == t0 + 3s);
+    CHECK(drain(queue, t0 + 2s).empty());
+    CHECK(drain(queue, t0 + 3s).size() == 1);
+}
+
+TEST_CASE("Global rate holds across many chats") {
+    OutboundQueue queue(OutboundLimits{}, t0);
+    for (int chat = 0; chat < 100; ++chat) {
+        queue.push(std::to_string(chat), "r", Priority::Reminder, t0);
+    }
+
+    // Step through time as a sender would and count sends per one-second window
+    std::map<long long, int> per_second;
+    auto now = t0;
+    while (auto ready = queue.next_ready(now)) {
+        now = *ready;
+        while (auto message = queue.pop(now)) {
+            ++per_second[std::chrono::duration_cast<std::chrono::seconds>(now - t0).count()];
+        }
+    }
+    int total = 0;
+    for (const auto& [second, sent] : per_second) {
+        CHECK(sent <= 30);
+        total += sent;
+    }
+    CHECK(total == 100);
+    CHECK(now - t0 < 3400ms);
+}
+
+TEST_CASE("retry_after pauses the chat and keeps the message first") {
+    OutboundQueue queue(chatLimitsOnly(), t0);
+    queue.push("1", "a", Priority::Reminder, t0);
+    queue.push("1", "b", Priority::Reminder, t0);
+
+    auto message = queue.pop(t0);
+    REQUIRE(message);
+    queue.retry_after(std::move(*message), 5s, t0);
+    CHECK(queue.size() == 2);
+    CHECK(queue.next_ready(t0) == t0 + 5s);
+    CHECK(drain(queue, t0 + 4s).empty());
+
+    auto sent = drain(queue, t0 + 5s);
+    REQUIRE(sent.size() == 1);
+    CHECK(sent[0].text == "a");
+    CHECK(drain(queue, t0 + 6s).front().text == "b");
+}
+
+TEST_CASE("Idle chats are forgotten once their bucket is full") {
+    OutboundQueue queue(chatLimitsOnly(), t0);
+    for (int chat = 0; chat < 50; ++chat) {
+        queue.push(std::to_string(chat), "r", Priority::Reminder, t0);
+    }
+    queue.push("-100", "g", Priority::Reminder, t0);
+    CHECK(drain(queue, t0).size() == 51);
+    CHECK(queue.chat_count() == 51);
+
+    // Still refilling: a new entry would let the next message out too early
+    CHECK_FALSE(queue.next_ready(t0 + 999ms));
+    CHECK(queue.chat_count() == 51);
+    CHECK_FALSE(queue.pop(t0 + 1s));
+    CHECK(queue.chat_count() == 1);
+    CHECK_FALSE(queue.pop(t0 + 3s));
+    CHECK(queue.chat_count() == 0);
+
+    // After a 429 the chat goes the same way once its retried message is out
+    queue.push("1", "a", Priority::Reminder, t0 + 3s);
+    auto message = queue.pop(t0 + 3s);
+    REQUIRE(message);
+    queue.retry_after(std::move(*message), 5s, t0 + 3s);
+    REQUIRE(drain(queue, t0 + 8s).size() == 1);
+    CHECK_FALSE(queue.pop(t0 + 9s));
+    CHECK(queue.chat_count() == 0);
+}
+
+TEST_CASE("Invalid limits are rejected") {
+    OutboundLimits limits;
+    limits.chat_per_second = 0;
+    CHECK_THROWS_AS(OutboundQueue(limits, t0), std::invalid_argument);
+}
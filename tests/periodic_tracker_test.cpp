@@ -26,13 +26,59 @@ TEST_CASE("Correct interval calculation") {
     CHECK(tracker.get_next_execution_time().value() == t2 + 2h);
 }
 
-TEST_CASE("Third execution throws exception") {
+TEST_CASE("Executions beyond the second are accepted") {
     PeriodicTracker tracker;
     auto t1 = PeriodicTracker::Clock::now();
     
-    tracker.mark_execution(t1);
-    tracker.mark_execution(t1 + 1h);
-    CHECK_THROWS_AS(tracker.mark_execution(t1 + 3h), std::logic_error);
+    for (int i = 0; i < 100; ++i) {
+        CHECK_NOTHROW(tracker.mark_execution(t1 + i * 1h));
+    }
+    CHECK(tracker.execution_count() == 100);
+    CHECK(tracker.get_interval() == 1h);
+    CHECK(tracker.get_interval_variance() == doctest::Approx(0.0));
+    CHECK(tracker.get_last_execution().value() == t1 + 99h);
+    CHECK(tracker.get_next_execution_time().value() == t1 + 100h);
+
+    auto recent = tracker.recent_executions();
+    REQUIRE(recent.size() == PeriodicTracker::kHistory);
+    CHECK(recent.front() == t1 + 96h);
+    CHECK(recent.back() == t1 + 99h);
+}
+
+TEST_CASE("Prediction follows a changed cadence") {
+    PeriodicTracker tracker;
+    auto time = PeriodicTracker::Clock::now();
+    
+    tracker.mark_execution(time);
+    for (int i = 0; i < 5; ++i) {
+        time += 1h;
+        tracker.mark_execution(time);
+    }
+    for (int i = 0; i < 30; ++i) {
+        time += 2h;
+        tracker.mark_execution(time);
+    }
+    
+    CHECK(tracker.get_min_interval() == 1h);
+    CHECK(tracker.get_max_interval() == 2h);
+    CHECK(tracker.get_interval() > 1h + 59min);
+    CHECK(tracker.get_interval() <= 2h);
+    CHECK(tracker.get_next_execution_time().value() == time + tracker.get_interval());
+}
+
+TEST_CASE("Variance grows with irregular intervals") {
+    PeriodicTracker tracker;
+    auto time = PeriodicTracker::Clock::now();
+    
+    tracker.mark_execution(time);
+    tracker.mark_execution(time += 1h);
+    CHECK(tracker.get_interval_variance() == doctest::Approx(0.0));
+    tracker.mark_execution(time += 3h);
+    
+    // mean = 3600 + 0.25 * 7200, variance = 0.75 * 7200 * 0.25 * 7200
+    CHECK(tracker.get_interval() == 1h + 30min);
+    CHECK(tracker.get_interval_variance() == doctest::Approx(0.75 * 7200.0 * 1800.0));
+    CHECK_THROWS_AS(PeriodicTracker().get_interval_variance(), std::logic_error);
 }
 
 TEST_CASE("Get interval before two executions throws") {
@@ -0,0 +1,104 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "recurrence_index.hpp"
+#include "task.hpp"
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Evaluation {
+    std::vector<std::int64_t> next;
+    std::vector<std::uint64_t> due;
+    std::size_t count = 0;
+};
+
+Evaluation run(const RecurrenceIndex& index, std::int64_t now, RecurrenceIndex::Kernel kernel) {
+    Evaluation result;
+    result.next.resize(index.size());
+    result.due.resize((index.size() + 63) / 64);
+    result.count = index.evaluate(now, result.next, result.due, kernel);
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Next fire times and due bits") {
+    RecurrenceIndex index;
+    index.add("hourly", 1000, 3600);
+    index.add("ended", 1000, 3600, 2000);
+    index.add("no_interval", 1000, 0);
+    index.add("later", 5000, 3600);
+
+    auto result = run(index, 4600, RecurrenceIndex::Kernel::Scalar);
+    CHECK(result.next == std::vector<std::int64_t>{4600, RecurrenceIndex::kNever, RecurrenceIndex::kNever, 8600});
+    CHECK(result.due[0] == 0b0001);
+    CHECK(result.count == 1);
+
+    index.mark_execution(0, 4600);
+    CHECK(index.due(4600).empty());
+    CHECK(index.due(8600) == std::vector<std::size_t>{0, 3});
+    CHECK(index.id(3) == "later");
+}
+
+TEST_CASE("Every supported kernel matches the scalar one") {
+    std::mt19937_64 rng(42);
+    const std::int64_t now = 1700000000;
+    std::uniform_int_distribution<std::int64_t> offset(-86400 * 30, 86400 * 30);
+    std::uniform_int_distribution<std::int64_t> interval(-3600, 86400 * 7);
+
+    // 64-entry blocks plus a partial tail
+    RecurrenceIndex index;
+    for (int i = 0; i < 64 * 5 + 37; ++i) {
+        const std::int64_t end = i % 3 == 0 ? now + offset(rng) : RecurrenceIndex::kNoEndDate;
+        index.add("task_" + std::to_string(i), now + offset(rng), interval(rng), end);
+    }
+
+    auto expected = run(index, now, RecurrenceIndex::Kernel::Scalar);
+    CHECK(expected.count > 0);
+    for (auto kernel : {RecurrenceIndex::Kernel::Best, RecurrenceIndex::Kernel::Sse42, RecurrenceIndex::Kernel::Avx2}) {
+        if (!RecurrenceIndex::supports(kernel)) {
+            CHECK_THROWS_AS(run(index, now, kernel), std::invalid_argument);
+            continue;
+        }
+        auto actual = run(index, now, kernel);
+        CHECK(actual.next == expected.next);
+        CHECK(actual.due == expected.due);
+        CHECK(actual.count == expected.count);
+    }
+}
+
+TEST_CASE("Tasks are indexed at the time they report") {
+    const auto now = std::chrono::system_clock::from_time_t(1700000000);
+    RecurrenceIndex index;
+
+    Task daily("Daily", "", Task::Type::Recurring, QDateTime(), 24h);
+    daily.mark_execution(now - 25h);
+    Task irregular("Irregular", "", Task::Type::Recurring, QDateTime(), 24h);
+    irregular.mark_execution(now - 50h);
+    irregular.mark_execution(now - 2h);  // observed cadence of 48h
+    Task once("Once", "", Task::Type::OneTime);
+
+    CHECK(index.add(daily, now));
+    CHECK(index.add(irregular, now));
+    CHECK_FALSE(index.add(once, now));
+    REQUIRE(index.size() == 2);
+
+    auto result = run(index, std::chrono::system_clock::to_time_t(now), RecurrenceIndex::Kernel::Best);
+    CHECK(result.next[0] == std::chrono::system_clock::to_time_t(*daily.next_execution_time(now)));
+    CHECK(result.next[1] == std::chrono::system_clock::to_time_t(*irregular.next_execution_time(now)));
+    CHECK(index.due(std::chrono::system_clock::to_time_t(now)) == std::vector<std::size_t>{0});
+}
+
+TEST_CASE("Output spans must fit the index") {
+    RecurrenceIndex index;
+    index.add("a", 0, 60);
+    std::vector<std::int64_t> next;
+    std::vector<std::uint64_t> due(1);
+    CHECK_THROWS_AS(index.evaluate(0, next, due), std::invalid_argument);
+}
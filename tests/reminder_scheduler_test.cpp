@@ -0,0 +1,76 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "reminder_scheduler.hpp"
+#include "task.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+const ReminderScheduler::TimePoint t0 = ReminderScheduler::Clock::from_time_t(1700000000);
+
+} // namespace
+
+TEST_CASE("Tasks come out in time order") {
+    ReminderScheduler scheduler;
+    scheduler.schedule("b", t0 + 2min);
+    scheduler.schedule("a", t0 + 1min);
+    scheduler.schedule("c", t0 + 3min);
+
+    CHECK(scheduler.next_due() == t0 + 1min);
+    CHECK(scheduler.pop_due(t0).empty());
+    CHECK(scheduler.pop_due(t0 + 2min) == std::vector<std::string>{"a", "b"});
+    CHECK(scheduler.size() == 1);
+    CHECK(scheduler.next_due() == t0 + 3min);
+}
+
+TEST_CASE("Rescheduling and cancelling replace the old entry") {
+    ReminderScheduler scheduler;
+    scheduler.schedule("a", t0 + 1min);
+    scheduler.schedule("b", t0 + 2min);
+    scheduler.schedule("a", t0 + 5min);
+    CHECK(scheduler.size() == 2);
+    CHECK(scheduler.next_due() == t0 + 2min);
+
+    CHECK(scheduler.cancel("b"));
+    CHECK_FALSE(scheduler.cancel("b"));
+    CHECK_FALSE(scheduler.contains("b"));
+    CHECK(scheduler.next_due() == t0 + 5min);
+    CHECK(scheduler.pop_due(t0 + 10min) == std::vector<std::string>{"a"});
+    CHECK_FALSE(scheduler.next_due());
+}
+
+TEST_CASE("Stale entries do not pile up") {
+    ReminderScheduler scheduler;
+    for (int i = 0; i < 10000; ++i) {
+        scheduler.schedule("same", t0 + std::chrono::seconds(i));
+    }
+    CHECK(scheduler.size() == 1);
+    CHECK(scheduler.next_due() == t0 + 9999s);
+    CHECK(scheduler.pop_due(t0 + 9998s).empty());
+    CHECK(scheduler.pop_due(t0 + 9999s).size() == 1);
+}
+
+TEST_CASE("Fire time of a task") {
+    Task once("Buy milk", "");
+    CHECK_FALSE(ReminderScheduler::fire_time(once, t0));
+    once.mark_completed(true);
+    CHECK(ReminderScheduler::fire_time(once, t0) == t0);
+
+    Task recurring("Water plants", "", Task::Type::Recurring, QDateTime(), 24h);
+    // Never executed: one interval from now
+    CHECK(ReminderScheduler::fire_time(recurring, t0) == t0 + 24h);
+
+    recurring.mark_execution(t0 - 1h);
+    CHECK(ReminderScheduler::fire_time(recurring, t0) == t0 + 23h);
+
+    // Two executions: the measured interval wins
+    recurring.mark_execution(t0);
+    CHECK(ReminderScheduler::fire_time(recurring, t0) == t0 + 1h);
+
+    recurring.set_status(Task::Status::Archived);
+    CHECK_FALSE(ReminderScheduler::fire_time(recurring, t0));
+}
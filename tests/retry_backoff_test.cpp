@@ -0,0 +1,54 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "retry_backoff.hpp"
+#include <chrono>
+#include <stdexcept>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Delays double up to the cap and stay within the jitter range") {
+    RetryBackoff backoff(100ms, 1s, 42);
+    std::chrono::milliseconds expected_ceiling = 100ms;
+    for (int attempt = 0; attempt < 10; ++attempt) {
+        auto delay = backoff.next();
+        CHECK(delay >= expected_ceiling / 2);
+        CHECK(delay <= expected_ceiling);
+        expected_ceiling = std::min(expected_ceiling * 2, std::chrono::milliseconds(1s));
+    }
+    CHECK(backoff.failures() == 10);
+}
+
+TEST_CASE("Reset starts from the initial delay") {
+    RetryBackoff backoff(100ms, 10s, 7);
+    for (int attempt = 0; attempt < 5; ++attempt) {
+        backoff.next();
+    }
+    backoff.reset();
+    CHECK(backoff.failures() == 0);
+    CHECK(backoff.next() <= 100ms);
+}
+
+TEST_CASE("Many failures do not overflow") {
+    RetryBackoff backoff(1ms, 60s, 1);
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        auto delay = backoff.next();
+        REQUIRE(delay <= 60s);
+        REQUIRE(delay.count() >= 0);
+    }
+    CHECK(backoff.next() >= 30s);
+}
+
+TEST_CASE("Clients with different seeds spread out") {
+    RetryBackoff a(1s, 60s, 1);
+    RetryBackoff b(1s, 60s, 2);
+    bool differed = false;
+    for (int attempt = 0; attempt < 5; ++attempt) {
+        differed = differed || a.next() != b.next();
+    }
+    CHECK(differed);
+}
+
+TEST_CASE("Invalid range is rejected") {
+    CHECK_THROWS_AS(RetryBackoff(0ms, 1s), std::invalid_argument);
+    CHECK_THROWS_AS(RetryBackoff(2s, 1s), std::invalid_argument);
+}
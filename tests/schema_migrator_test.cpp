@@ -0,0 +1,73 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "schema_migrator.hpp"
+#include <sqlite3.h>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+struct MemoryDb {
+    MemoryDb() { sqlite3_open(":memory:", &db); }
+    ~MemoryDb() { sqlite3_close(db); }
+
+    int count(const char* sql) {
+        sqlite3_stmt* stmt = nullptr;
+        sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+        int value = sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int(stmt, 0) : -1;
+        sqlite3_finalize(stmt);
+        return value;
+    }
+
+    sqlite3* db = nullptr;
+    std::recursive_mutex mutex;
+};
+
+void addItems(SchemaMigrator& migrator) {
+    migrator.add(1, "items", "CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT);");
+    migrator.add(2, "seed", "INSERT INTO items (name) VALUES ('a'), ('b');");
+}
+
+} // namespace
+
+TEST_CASE("Migrations run once and in order") {
+    MemoryDb mem;
+    SchemaMigrator migrator(mem.db, mem.mutex);
+    addItems(migrator);
+
+    CHECK(migrator.current_version() == 0);
+    CHECK(migrator.migrate() == 2);
+    CHECK(migrator.current_version() == 2);
+    CHECK(mem.count("SELECT COUNT(*) FROM items;") == 2);
+
+    // Already current: nothing is executed again
+    CHECK(migrator.migrate() == 0);
+    CHECK(mem.count("SELECT COUNT(*) FROM items;") == 2);
+
+    migrator.add(3, "backfill", [](sqlite3* db) {
+        SchemaMigrator::exec(db, "UPDATE items SET name = upper(name);");
+    });
+    CHECK(migrator.migrate() == 1);
+    CHECK(mem.count("SELECT COUNT(*) FROM items WHERE name IN ('A', 'B');") == 2);
+}
+
+TEST_CASE("A failing migration is rolled back") {
+    MemoryDb mem;
+    SchemaMigrator migrator(mem.db, mem.mutex);
+    addItems(migrator);
+    migrator.add(3, "broken", "INSERT INTO items (name) VALUES ('c'); INSERT INTO missing VALUES (1);");
+
+    CHECK_THROWS_AS(migrator.migrate(), std::runtime_error);
+    CHECK(migrator.current_version() == 2);
+    CHECK(mem.count("SELECT COUNT(*) FROM items;") == 2);
+}
+
+TEST_CASE("Version checks") {
+    MemoryDb mem;
+    SchemaMigrator migrator(mem.db, mem.mutex);
+    CHECK_THROWS_AS(migrator.add(2, "gap", "SELECT 1;"), std::invalid_argument);
+
+    addItems(migrator);
+    SchemaMigrator::exec(mem.db, "PRAGMA user_version = 5;");
+    CHECK_THROWS_AS(migrator.migrate(), std::runtime_error);
+}
@@ -55,4 +55,46 @@ TEST_CASE("Marking task as completed") {
     task.mark_completed(true);
 
     CHECK(task.is_completed());
-}
\ No newline at end of file
+}
+
+TEST_CASE("Completion and status stay in step") {
+    Task task("Water plants", "");
+    task.mark_completed(true);
+    CHECK(task.get_status() == Task::Status::Completed);
+
+    task.mark_completed(false);
+    CHECK(task.get_status() == Task::Status::Active);
+
+    task.set_status(Task::Status::Completed);
+    CHECK(task.is_completed());
+    task.set_status(Task::Status::Archived);
+    CHECK_FALSE(task.is_completed());
+}
+
+TEST_CASE("Views and in-place assignment") {
+    Task task("Title", "Description");
+    CHECK(task.get_title_view() == "Title");
+    CHECK(task.get_description_view() == "Description");
+    CHECK(task.get_id_view() == task.get_id());
+
+    task.assign_id("1234567890123_0001_too_long");
+    CHECK(task.get_id_view() == "1234567890123_0001");
+    task.assign_title("Other");
+    task.assign_description("");
+    CHECK(task.get_title() == "Other");
+    CHECK(task.get_description().empty());
+}
+
+TEST_CASE("Type and recurring flag stay in step") {
+    Task task("Water plants", "");
+    CHECK_FALSE(task.is_recurring());
+
+    // As when a recurring row is loaded into a reused Task
+    task.set_type(Task::Type::Recurring);
+    CHECK(task.is_recurring());
+    task.mark_execution(std::chrono::system_clock::now());
+    CHECK(task.get_tracker().get_last_execution().has_value());
+
+    task.set_type(Task::Type::OneTime);
+    CHECK_FALSE(task.is_recurring());
+}
@@ -0,0 +1,80 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "telegram_update.hpp"
+#include <cstdint>
+#include <string>
+
+namespace {
+
+std::string textUpdate(std::int64_t update_id, std::int64_t chat_id, const std::string& text) {
+    return R"({"update_id":)" + std::to_string(update_id) +
+           R"(,"message":{"message_id":1,"chat":{"id":)" + std::to_string(chat_id) +
+           R"(,"type":"private"},"date":1718000000,"text":")" + text + R"("}})";
+}
+
+} // namespace
+
+TEST_CASE("Only the message's own chat and text are taken") {
+    // Field order differs from Telegram's and the reply carries its own chat and text
+    const std::string body = R"({"ok":true,"result":[)"
+        R"({"message":{"text":"/start","reply_to_message":{"chat":{"id":7},"text":"старый"},"chat":{"id":42}},"update_id":10},)"
+        R"({"update_id":11,"callback_query":{"id":"1","message":{"chat":{"id":42},"text":"кнопка"}}},)"
+        R"({"update_id":12,"message":{"chat":{"id":42},"photo":[{"file_id":"x","width":90}]}})"
+        R"(]})";
+
+    std::int64_t last_update_id = 0;
+    auto messages = TelegramUpdateParser::parse_get_updates(body, last_update_id);
+    REQUIRE(messages.size() == 1);
+    CHECK(messages[0].update_id == 10);
+    CHECK(messages[0].chat_id == "42");
+    CHECK(messages[0].text == "/start");
+    // Skipped updates still advance the offset
+    CHECK(last_update_id == 12);
+}
+
+TEST_CASE("Escapes in texts are decoded") {
+    auto message = TelegramUpdateParser::parse_webhook(textUpdate(1, 42, R"(/add_task \"Хлеб\", без спешки)"));
+    REQUIRE(message);
+    CHECK(message->text == "/add_task \"Хлеб\", без спешки");
+}
+
+TEST_CASE("One parser serves many polls") {
+    TelegramUpdateParser parser;
+    std::int64_t last_update_id = 0;
+
+    // A backlog after downtime: one large response
+    std::string backlog = R"({"ok":true,"result":[)";
+    for (int i = 1; i <= 5000; ++i) {
+        backlog += (i > 1 ? "," : "") + textUpdate(i, 1000 + i % 7, "/complete_task " + std::to_string(i));
+    }
+    backlog += "]}";
+    auto& first = parser.parse(backlog, last_update_id);
+    REQUIRE(first.size() == 5000);
+    CHECK(first.back().text == "/complete_task 5000");
+    CHECK(first.back().chat_id == "1002");
+    CHECK(last_update_id == 5000);
+
+    auto& next = parser.parse(R"({"ok":true,"result":[)" + textUpdate(5001, 42, "/start") + "]}", last_update_id);
+    REQUIRE(next.size() == 1);
+    CHECK(next[0].update_id == 5001);
+
+    CHECK(parser.parse(R"({"ok":true,"result":[]})", last_update_id).empty());
+    CHECK(last_update_id == 5001);
+}
+
+TEST_CASE("Errors and malformed bodies") {
+    TelegramUpdateParser parser;
+    std::int64_t last_update_id = 5;
+
+    // An error response does not move the offset, even with stray ids in it
+    CHECK(parser.parse(R"({"ok":false,"error_code":409,"result":[{"update_id":99}]})", last_update_id).empty());
+    CHECK(last_update_id == 5);
+
+    CHECK_THROWS(parser.parse(R"({"ok":true,"result":[{"update_id":6,"message":)", last_update_id));
+    CHECK_THROWS(parser.parse("", last_update_id));
+    CHECK(last_update_id == 5);
+
+    CHECK(parser.parse("[]", last_update_id).empty());
+    CHECK(parser.parse("42", last_update_id).empty());
+    CHECK_FALSE(TelegramUpdateParser::parse_webhook(R"({"update_id":7})"));
+}
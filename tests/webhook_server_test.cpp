@@ -0,0 +1,187 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "curl_handle.hpp"
+#include "http_request_parser.hpp"
+#include "telegram_update.hpp"
+#include "webhook_server.hpp"
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <curl/curl.h>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Updates as Telegram delivered them to a test bot (ids shortened)
+const std::vector<std::string> kRecordedUpdates = {
+    R"({"update_id":700000001,"message":{"message_id":11,"from":{"id":42,"is_bot":false,"first_name":"Anna"},"chat":{"id":42,"first_name":"Anna","type":"private"},"date":1718000000,"text":"/start","entities":[{"offset":0,"length":6,"type":"bot_command"}]}})",
+    R"({"update_id":700000002,"message":{"message_id":12,"from":{"id":42,"is_bot":false,"first_name":"Anna"},"chat":{"id":42,"first_name":"Anna","type":"private"},"date":1718000005,"text":"/add_task Купить хлеб, к ужину"}})",
+    R"({"update_id":700000003,"edited_message":{"message_id":12,"chat":{"id":42,"type":"private"},"date":1718000005,"edit_date":1718000010,"text":"/add_task Купить молоко"}})",
+    R"({"update_id":700000004,"message":{"message_id":5,"chat":{"id":-1001234567890,"title":"Семья","type":"supergroup"},"date":1718000020,"text":"/complete_task 1718000000000_0001"}})",
+};
+
+std::string request(const std::string& head, const std::string& body) {
+    return head + "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+}
+
+size_t discardBody(char*, size_t size, size_t nmemb, void*) {
+    return size * nmemb;
+}
+
+} // namespace
+
+TEST_CASE("Request split across reads is assembled") {
+    HttpRequestParser parser;
+    const std::string raw = request("POST /telegram/webhook HTTP/1.1\r\nHost: bot\r\nX-Telegram-Bot-Api-Secret-Token: abc\r\n", "{\"a\":1}");
+
+    CHECK(parser.feed(raw.substr(0, 10)) == HttpRequestParser::Result::NeedMore);
+    CHECK(parser.feed(raw.substr(10, raw.size() - 13)) == HttpRequestParser::Result::NeedMore);
+    REQUIRE(parser.feed(raw.substr(raw.size() - 3)) == HttpRequestParser::Result::Complete);
+
+    HttpRequest parsed = parser.take();
+    CHECK(parsed.method == "POST");
+    CHECK(parsed.target == "/telegram/webhook");
+    CHECK(parsed.header("x-telegram-bot-api-secret-token") == "abc");
+    CHECK(parsed.body == "{\"a\":1}");
+    CHECK(parsed.keep_alive);
+}
+
+TEST_CASE("Request fed byte by byte is assembled") {
+    HttpRequestParser parser;
+    const std::string body(4096, 'b');
+    const std::string next = request("GET /next HTTP/1.1\r\n", "");
+    const std::string raw = request("POST /telegram/webhook HTTP/1.1\r\nHost: bot\r\n", body) + next;
+
+    // The head is parsed once its last byte arrives, then only the body length is checked
+    std::size_t fed = 0;
+    while (parser.feed(std::string_view(raw).substr(fed, 1)) == HttpRequestParser::Result::NeedMore) {
+        ++fed;
+    }
+    CHECK(fed + 1 == raw.size() - next.size());
+    HttpRequest parsed = parser.take();
+    CHECK(parsed.target == "/telegram/webhook");
+    CHECK(parsed.body == body);
+
+    for (++fed; fed < raw.size() - 1; ++fed) {
+        CHECK(parser.feed(std::string_view(raw).substr(fed, 1)) == HttpRequestParser::Result::NeedMore);
+    }
+    REQUIRE(parser.feed(std::string_view(raw).substr(fed, 1)) == HttpRequestParser::Result::Complete);
+    CHECK(parser.take().target == "/next");
+}
+
+TEST_CASE("Pipelined requests come out one by one") {
+    HttpRequestParser parser;
+    const std::string raw = request("POST /a HTTP/1.1\r\n", "first") +
+                            request("POST /b HTTP/1.1\r\nConnection: close\r\n", "second");
+
+    REQUIRE(parser.feed(raw) == HttpRequestParser::Result::Complete);
+    CHECK(parser.take().body == "first");
+    REQUIRE(parser.feed({}) == HttpRequestParser::Result::Complete);
+    HttpRequest second = parser.take();
+    CHECK(second.body == "second");
+    CHECK_FALSE(second.keep_alive);
+    CHECK(parser.feed({}) == HttpRequestParser::Result::NeedMore);
+}
+
+TEST_CASE("Malformed and oversized requests are rejected") {
+    HttpRequestParser garbage;
+    CHECK(garbage.feed("hello\r\n\r\n") == HttpRequestParser::Result::Error);
+
+    HttpRequestParser large(16);
+    CHECK(large.feed("POST / HTTP/1.1\r\nContent-Length: 17\r\n\r\n") == HttpRequestParser::Result::Error);
+
+    HttpRequestParser chunked;
+    CHECK(chunked.feed("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n") == HttpRequestParser::Result::Error);
+
+    HttpRequestParser endless(1024, 64);
+    CHECK(endless.feed(std::string(100, 'x')) == HttpRequestParser::Result::Error);
+}
+
+TEST_CASE("Webhook bodies and getUpdates responses parse to the same messages") {
+    auto start = TelegramUpdateParser::parse_webhook(kRecordedUpdates[0]);
+    REQUIRE(start);
+    CHECK(start->update_id == 700000001);
+    CHECK(start->chat_id == "42");
+    CHECK(start->text == "/start");
+
+    CHECK_FALSE(TelegramUpdateParser::parse_webhook(kRecordedUpdates[2]));
+    CHECK(TelegramUpdateParser::parse_webhook(kRecordedUpdates[3])->chat_id == "-1001234567890");
+    CHECK_THROWS(TelegramUpdateParser::parse_webhook("not json"));
+
+    std::string batch = R"({"ok":true,"result":[)";
+    for (std::size_t i = 0; i < kRecordedUpdates.size(); ++i) {
+        batch += (i ? "," : "") + kRecordedUpdates[i];
+    }
+    batch += "]}";
+
+    std::int64_t last_update_id = 0;
+    auto messages = TelegramUpdateParser::parse_get_updates(batch, last_update_id);
+    REQUIRE(messages.size() == 3);
+    CHECK(messages[1].text == "/add_task Купить хлеб, к ужину");
+    CHECK(last_update_id == 700000004);
+
+    CHECK(TelegramUpdateParser::parse_get_updates(R"({"ok":false,"error_code":409})", last_update_id).empty());
+}
+
+TEST_CASE("Recorded updates replayed over HTTP reach the handler") {
+    int argc = 1;
+    char name[] = "webhook_server_test";
+    char* argv[] = {name, nullptr};
+    QCoreApplication app(argc, argv);
+
+    std::vector<IncomingMessage> received;
+    WebhookOptions options;
+    options.port = 0;
+    options.secret = "s3cret";
+    WebhookServer server(options, [&](const std::string& body) {
+        if (auto message = TelegramUpdateParser::parse_webhook(body)) {
+            received.push_back(std::move(*message));
+        }
+    });
+    server.listen();
+    const std::string base = "http://127.0.0.1:" + std::to_string(server.port());
+
+    // The client runs on its own thread while this one drives the Qt event loop
+    std::vector<long> statuses;
+    std::atomic<bool> finished{false};
+    std::thread client([&]() {
+        CurlHandle curl;  // one handle, so the updates share a keep-alive connection
+        auto post = [&](const std::string& path, const std::string& secret, const std::string& body) {
+            curl_slist* headers = curl_slist_append(nullptr, "Content-Type: application/json");
+            headers = curl_slist_append(headers, ("X-Telegram-Bot-Api-Secret-Token: " + secret).c_str());
+            const std::string url = base + path;
+            curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discardBody);
+            long status = 0;
+            if (curl_easy_perform(curl) == CURLE_OK) {
+                curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+            }
+            curl_slist_free_all(headers);
+            statuses.push_back(status);
+        };
+        for (const auto& update : kRecordedUpdates) {
+            post(options.path, "s3cret", update);
+        }
+        post(options.path, "wrong", kRecordedUpdates[0]);
+        post("/other", "s3cret", kRecordedUpdates[0]);
+        finished = true;
+    });
+
+    while (!finished) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    client.join();
+
+    CHECK(statuses == std::vector<long>{200, 200, 200, 200, 401, 404});
+    CHECK(server.updates_received() == kRecordedUpdates.size());
+    REQUIRE(received.size() == 3);
+    CHECK(received[0].text == "/start");
+    CHECK(received[1].chat_id == "42");
+    CHECK(received[2].text == "/complete_task 1718000000000_0001");
+    server.close();
+}